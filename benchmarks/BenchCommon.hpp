@@ -0,0 +1,35 @@
+#ifndef BENCH_COMMON_HPP
+#define BENCH_COMMON_HPP
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+// 基准程序共用的计时与参数工具；各基准只打印结果，不做断言之外的判定
+namespace Bench {
+
+class Timer {
+public:
+  Timer() : m_start(std::chrono::steady_clock::now()) {}
+  double Seconds() const { return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count(); }
+  double Millis() const { return Seconds() * 1e3; }
+  void Restart() { m_start = std::chrono::steady_clock::now(); }
+
+private:
+  std::chrono::steady_clock::time_point m_start;
+};
+
+// 第index个命令行参数转为整数，缺省时返回fallback
+inline long ArgOr(int argc, char **argv, int index, long fallback) {
+  return argc > index ? std::strtol(argv[index], nullptr, 10) : fallback;
+}
+
+// 阻止编译器把基准循环的结果优化掉
+template <typename T> inline void DoNotOptimize(const T &value) { asm volatile("" : : "r,m"(value) : "memory"); }
+
+inline void Report(const char *name, double value, const char *unit) { std::printf("%-36s %12.3f %s\n", name, value, unit); }
+
+} // namespace Bench
+
+#endif // BENCH_COMMON_HPP
@@ -0,0 +1,70 @@
+// 冷启动与.csvbin快照热启动的加载耗时对比
+// 用法：BinaryCacheBenchmark [行数，默认1000000] [热启动次数，默认5]
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+
+#include <unistd.h>
+
+#include "BenchCommon.hpp"
+#include "CSVReader.h"
+
+namespace fs = std::filesystem;
+
+static void WriteSweepFile(const std::string &path, long rows) {
+  std::mt19937 rng(1);
+  std::ofstream out(path, std::ios::binary);
+  out << "Freq,Power,Gain,Tag\n";
+  for (long i = 0; i < rows; ++i)
+    out << 100 + static_cast<double>(rng() % 300000) / 100 << ',' << -static_cast<int>(rng() % 60) << ','
+        << static_cast<double>(rng() % 1000) / 10 << ",cal" << i % 16 << '\n';
+}
+
+static size_t Load(const std::string &path, const std::string *cache_dir, ParseProfile::Source &source) {
+  CSVParser parser(ParseMode::Synchronous);
+  parser.SetColumnSchema({{"Freq", ColumnType::Double}, {"Power", ColumnType::Double}, {"Gain", ColumnType::Double}});
+  if (cache_dir)
+    parser.EnableBinaryCache(*cache_dir);
+  parser.ParseDataFromCSV(path);
+  source = parser.GetParseProfile().source;
+  return parser.GetCSVDataSize();
+}
+
+int main(int argc, char **argv) {
+  const long rows = Bench::ArgOr(argc, argv, 1, 1000000);
+  const int warm_runs = static_cast<int>(Bench::ArgOr(argc, argv, 2, 5));
+  const auto dir = fs::temp_directory_path() / ("csvbin_bench_" + std::to_string(::getpid()));
+  const auto cache_dir = (dir / "cache").string();
+  fs::create_directories(dir);
+  const auto csv = (dir / "sweep.csv").string();
+  WriteSweepFile(csv, rows);
+  std::printf("rows %ld, csv %ju bytes\n", rows, static_cast<uintmax_t>(fs::file_size(csv)));
+
+  ParseProfile::Source source;
+  Bench::Timer timer;
+  size_t loaded = Load(csv, nullptr, source);
+  Bench::Report("cold parse, cache off", timer.Millis(), "ms");
+
+  timer.Restart();
+  loaded += Load(csv, &cache_dir, source);
+  Bench::Report("cold parse + snapshot write", timer.Millis(), "ms");
+  const auto snapshot = CSVUtils::BinaryCache::SnapshotPath(csv, cache_dir);
+  std::printf("snapshot %ju bytes\n", static_cast<uintmax_t>(fs::file_size(snapshot)));
+
+  double warm_ms = 0;
+  for (int i = 0; i < warm_runs; ++i) {
+    timer.Restart();
+    loaded += Load(csv, &cache_dir, source);
+    warm_ms += timer.Millis();
+    if (source != ParseProfile::Source::Snapshot) {
+      std::printf("warm load did not use the snapshot\n");
+      return 1;
+    }
+  }
+  Bench::Report("warm load from snapshot (avg)", warm_ms / warm_runs, "ms");
+  Bench::DoNotOptimize(loaded);
+  fs::remove_all(dir);
+  return 0;
+}
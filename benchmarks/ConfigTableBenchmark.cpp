@@ -0,0 +1,84 @@
+// ConfigTable注册表读取在1~64个线程下的竞争开销：
+// GetParser命中路径，以及发布指针的两种原子读取方式（自由函数atomic_load与std::atomic<std::shared_ptr>）
+// 用法：ConfigTableBenchmark [每轮总查找次数，默认400000]
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "BenchCommon.hpp"
+#include "ConfigTable.hpp"
+
+namespace fs = std::filesystem;
+
+static constexpr int kFiles = 20;
+static constexpr int kThreadCounts[] = {1, 2, 4, 8, 16, 32, 64};
+
+// 在threads个线程上共执行total次body(thread, i)，返回每次的平均纳秒数
+template <typename Body> static double RunThreads(int threads, long total, Body body) {
+  std::atomic<bool> go{false};
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&, t] {
+      while (!go.load(std::memory_order_acquire))
+        std::this_thread::yield();
+      for (long i = 0; i < total / threads; ++i)
+        body(t, i);
+    });
+  }
+  Bench::Timer timer;
+  go.store(true, std::memory_order_release);
+  for (auto &worker : workers)
+    worker.join();
+  return timer.Seconds() * 1e9 / static_cast<double>(total);
+}
+
+int main(int argc, char **argv) {
+  const long total = Bench::ArgOr(argc, argv, 1, 400000);
+  const auto root = fs::temp_directory_path() / ("config_table_bench_" + std::to_string(::getpid()));
+  fs::create_directories(root / "FE");
+  std::vector<std::string> names;
+  for (int i = 0; i < kFiles; ++i) {
+    names.push_back("FE" + std::to_string(i) + ".csv");
+    std::ofstream(root / "FE" / names.back()) << "Freq,Power\n1,2\n";
+  }
+
+  auto &manager = CFGFileManager::GetInstance();
+  manager.SetRootPath(root.string());
+  for (const auto &name : names)
+    manager.GetParser("FE", name);
+
+  struct Payload {
+    int value = 1;
+  };
+  std::shared_ptr<const Payload> pooled = std::make_shared<const Payload>();
+  std::atomic<std::shared_ptr<const Payload>> member{std::make_shared<const Payload>()};
+
+  std::printf("%ld lookups per round, %u hardware threads\n", total, std::thread::hardware_concurrency());
+  for (int threads : kThreadCounts) {
+    char name[64];
+    std::snprintf(name, sizeof(name), "GetParser hit, %d threads", threads);
+    Bench::Report(name, RunThreads(threads, total, [&](int t, long i) {
+                    Bench::DoNotOptimize(manager.GetParser("FE", names[(i + t) % kFiles]).get());
+                  }),
+                  "ns/op");
+    std::snprintf(name, sizeof(name), "atomic_load(shared_ptr*), %d threads", threads);
+    Bench::Report(name, RunThreads(threads, total, [&](int, long) {
+                    Bench::DoNotOptimize(std::atomic_load_explicit(&pooled, std::memory_order_acquire)->value);
+                  }),
+                  "ns/op");
+    std::snprintf(name, sizeof(name), "atomic<shared_ptr>::load, %d threads", threads);
+    Bench::Report(name, RunThreads(threads, total, [&](int, long) {
+                    Bench::DoNotOptimize(member.load(std::memory_order_acquire)->value);
+                  }),
+                  "ns/op");
+  }
+  fs::remove_all(root);
+  return 0;
+}
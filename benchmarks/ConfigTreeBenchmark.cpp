@@ -0,0 +1,136 @@
+// 配置树的内存与查找开销：CFGFileTree（连续节点数组 + 一次哈希探测）对比原先每节点一个shared_ptr的树
+// 内存按全局operator new统计存活块的malloc_usable_size，只含堆分配
+// 用法：ConfigTreeBenchmark [模块数，默认16] [每个模块的文件数，默认256] [查找次数，默认2000000]
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <malloc.h>
+
+#include "BenchCommon.hpp"
+#include "CFGFileTree.hpp"
+
+static size_t g_live_bytes = 0;
+static size_t g_live_blocks = 0;
+
+void *operator new(size_t size) {
+  void *p = std::malloc(size ? size : 1);
+  if (!p)
+    throw std::bad_alloc();
+  g_live_bytes += malloc_usable_size(p);
+  ++g_live_blocks;
+  return p;
+}
+void operator delete(void *p) noexcept {
+  if (!p)
+    return;
+  g_live_bytes -= malloc_usable_size(p);
+  --g_live_blocks;
+  std::free(p);
+}
+void operator delete(void *p, size_t) noexcept { operator delete(p); }
+
+// 原先CFGFileNode的结构：每个节点单独分配，子节点放在unordered_map<string, shared_ptr>中，父节点为weak_ptr
+class SharedPtrNode : public std::enable_shared_from_this<SharedPtrNode> {
+public:
+  using Ptr = std::shared_ptr<SharedPtrNode>;
+
+  static Ptr Create(const std::string &name, const std::string &file_path = "") {
+    return Ptr(new SharedPtrNode(name, file_path));
+  }
+  void AddChild(const std::string &name, const Ptr &child) {
+    if (!m_file_path.empty())
+      throw std::runtime_error("Cannot add child to a file node");
+    child->m_parent = shared_from_this();
+    m_children[name] = child;
+  }
+  Ptr GetChild(const std::string &name) const {
+    auto it = m_children.find(name);
+    return it != m_children.end() ? it->second : nullptr;
+  }
+  const std::string &GetFilePath() const { return m_file_path; }
+
+private:
+  SharedPtrNode(const std::string &name, const std::string &file_path) : m_name(name), m_file_path(file_path) {}
+
+  std::string m_name;
+  std::string m_file_path;
+  std::weak_ptr<SharedPtrNode> m_parent;
+  std::unordered_map<std::string, Ptr> m_children;
+};
+
+struct HeapUsage {
+  size_t bytes;
+  size_t blocks;
+};
+template <typename Build> static HeapUsage Measure(Build build) {
+  const size_t bytes = g_live_bytes, blocks = g_live_blocks;
+  build();
+  return {g_live_bytes - bytes, g_live_blocks - blocks};
+}
+
+int main(int argc, char **argv) {
+  const long modules = Bench::ArgOr(argc, argv, 1, 16);
+  const long files = Bench::ArgOr(argc, argv, 2, 256);
+  const long lookups = Bench::ArgOr(argc, argv, 3, 2000000);
+  const std::string root = "/opt/rf/Configs";
+  std::vector<std::pair<std::string, std::string>> names;
+  for (long m = 0; m < modules; ++m) {
+    for (long f = 0; f < files; ++f)
+      names.emplace_back("Module" + std::to_string(m), "Table" + std::to_string(f) + ".csv");
+  }
+
+  SharedPtrNode::Ptr shared;
+  const auto sharedUsage = Measure([&] {
+    shared = SharedPtrNode::Create(root);
+    for (const auto &[module, file] : names) {
+      auto dir = shared->GetChild(module);
+      if (!dir) {
+        dir = SharedPtrNode::Create(module);
+        shared->AddChild(module, dir);
+      }
+      dir->AddChild(file, SharedPtrNode::Create(file, root + "/" + module + "/" + file));
+    }
+  });
+  std::unique_ptr<CFGFileTree> flat;
+  const auto flatUsage = Measure([&] {
+    flat = std::make_unique<CFGFileTree>(root);
+    for (const auto &[module, file] : names)
+      flat->AddFile(flat->AddDirectory(CFGFileTree::kRoot, module), file, root + "/" + module + "/" + file);
+  });
+
+  std::printf("%zu files in %ld modules, %ld lookups\n", names.size(), modules, lookups);
+  Bench::Report("shared_ptr tree heap", static_cast<double>(sharedUsage.bytes) / 1024, "KiB");
+  Bench::Report("shared_ptr tree live blocks", static_cast<double>(sharedUsage.blocks), "");
+  Bench::Report("CFGFileTree heap", static_cast<double>(flatUsage.bytes) / 1024, "KiB");
+  Bench::Report("CFGFileTree live blocks", static_cast<double>(flatUsage.blocks), "");
+
+  // 按固定步长跳着查，避免顺序访问让两种结构都只命中缓存中的相邻节点
+  auto nameAt = [&](long i) -> const std::pair<std::string, std::string> & {
+    return names[static_cast<size_t>(i) * 7919 % names.size()];
+  };
+  Bench::Timer timer;
+  for (long i = 0; i < lookups; ++i) {
+    const auto &[module, file] = nameAt(i);
+    Bench::DoNotOptimize(shared->GetChild(module)->GetChild(file)->GetFilePath().size());
+  }
+  Bench::Report("shared_ptr tree GetChild x2", timer.Seconds() * 1e9 / static_cast<double>(lookups), "ns/op");
+  timer.Restart();
+  for (long i = 0; i < lookups; ++i) {
+    const auto &[module, file] = nameAt(i);
+    Bench::DoNotOptimize(flat->FilePath(flat->Find(flat->Find(CFGFileTree::kRoot, module), file)).size());
+  }
+  Bench::Report("CFGFileTree Find x2", timer.Seconds() * 1e9 / static_cast<double>(lookups), "ns/op");
+  timer.Restart();
+  for (long i = 0; i < lookups; ++i) {
+    const auto &[module, file] = nameAt(i);
+    Bench::DoNotOptimize(flat->FilePath(flat->FindPath(module, file)).size());
+  }
+  Bench::Report("CFGFileTree FindPath", timer.Seconds() * 1e9 / static_cast<double>(lookups), "ns/op");
+  return 0;
+}
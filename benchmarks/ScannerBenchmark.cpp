@@ -0,0 +1,64 @@
+// 分隔符扫描吞吐：各位图实现的纯扫描速度，以及SplitRow行、列切分的端到端速度
+// 用法：ScannerBenchmark [数据MiB，默认128] [重复次数，默认3]
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "BenchCommon.hpp"
+#include "CSVReader.h"
+
+using namespace CSVUtils;
+
+// 合成的扫频数据行：频点、功率、档位与两个文本列，"\r\n"结尾
+static std::string MakeSweepData(size_t bytes) {
+  std::string data;
+  data.reserve(bytes + 128);
+  for (size_t i = 0; data.size() < bytes; ++i) {
+    data += std::to_string(1e6 + i * 1000.5) + "," + std::to_string(-static_cast<long>(i % 50)) + "," +
+            std::to_string(i % 7) + ",0.12345,abcdef\r\n";
+  }
+  return data;
+}
+
+int main(int argc, char **argv) {
+  const size_t mib = static_cast<size_t>(Bench::ArgOr(argc, argv, 1, 128));
+  const int repeat = static_cast<int>(Bench::ArgOr(argc, argv, 2, 3));
+  const std::string data = MakeSweepData(mib << 20);
+  const double total = static_cast<double>(data.size()) * repeat;
+  std::printf("data %zu bytes x %d\n", data.size(), repeat);
+
+  struct Builder {
+    const char *name;
+    Scanner::MaskBuilder build;
+    bool supported;
+  };
+  std::vector<Builder> builders = {{"scan scalar", Scanner::ScalarMask, true}};
+#ifdef CSV_SCANNER_X86
+  builders.push_back({"scan sse2", Scanner::Sse2Mask, static_cast<bool>(__builtin_cpu_supports("sse2"))});
+  builders.push_back({"scan avx2", Scanner::Avx2Mask, static_cast<bool>(__builtin_cpu_supports("avx2"))});
+#endif
+  for (const auto &builder : builders) {
+    if (!builder.supported) {
+      std::printf("%-36s %12s\n", builder.name, "unsupported");
+      continue;
+    }
+    size_t fields = 0;
+    Bench::Timer timer;
+    for (int k = 0; k < repeat; ++k)
+      Scanner::ForEachField(data, ',', [&fields](std::string_view) { ++fields; }, builder.build);
+    Bench::DoNotOptimize(fields);
+    Bench::Report(builder.name, total / timer.Seconds() / 1e9, "GB/s");
+  }
+
+  // 先按行切分，再逐行按列切分，与ParseRows + ParseColumns的路径一致
+  size_t cells = 0;
+  Bench::Timer timer;
+  for (int k = 0; k < repeat; ++k) {
+    for (auto row : ParseOperations::SplitRow(data, '\n'))
+      cells += ParseOperations::SplitRow(row, ',', 5).size();
+  }
+  Bench::DoNotOptimize(cells);
+  Bench::Report("SplitRow rows+columns", total / timer.Seconds() / 1e9, "GB/s");
+  return 0;
+}
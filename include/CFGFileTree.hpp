@@ -0,0 +1,281 @@
+#ifndef CFG_FILE_TREE_HPP
+#define CFG_FILE_TREE_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "CSVStringArena.hpp"
+
+/**
+ * @brief 扁平的配置目录树：全部节点存放在一个连续数组中，父子与兄弟关系都用下标表示
+ * 路径字符串存放在StringArena中，节点名与相对路径（如 FE/FE1.csv）尽量取完整路径的后缀，不单独存放；
+ * 节点按路径哈希登记在一张开放寻址表里，按(父节点, 名字)或按相对路径查找都只需一次哈希探测。
+ * 删除节点后其槽位进入空闲表，之后新增的节点复用；树本身不加锁，由使用方同步。
+ * 修改树（包括删除时的字符串整理）后，之前取得的名字与路径视图可能失效
+ */
+class CFGFileTree {
+public:
+  using NodeIndex = uint32_t;
+  static constexpr NodeIndex kNoNode = UINT32_MAX;
+  static constexpr NodeIndex kRoot = 0;
+
+  explicit CFGFileTree(std::string_view root_name = {}) { Reset(root_name); }
+  CFGFileTree(const CFGFileTree &) = delete;
+  CFGFileTree &operator=(const CFGFileTree &) = delete;
+
+  // 清空整棵树，只保留名为root_name的根目录
+  void Reset(std::string_view root_name) {
+    m_nodes.clear();
+    m_free.clear();
+    m_arena.Rollback(StringArena::Mark{});
+    m_table.assign(kMinTableSize, kNoNode);
+    m_live = 1;
+    m_dead_bytes = 0;
+    Node root;
+    root.name = m_arena.Store(root_name);
+    root.hash = kHashBasis;
+    m_nodes.push_back(root);
+  }
+
+  // 已存在同名目录时返回它；parent不是目录或同名节点是文件时返回kNoNode
+  NodeIndex AddDirectory(NodeIndex parent, std::string_view name) { return Add(parent, name, {}); }
+  // 已存在同名文件时更新其路径；parent不是目录或同名节点是目录时返回kNoNode
+  NodeIndex AddFile(NodeIndex parent, std::string_view name, std::string_view file_path) {
+    return file_path.empty() ? kNoNode : Add(parent, name, file_path);
+  }
+  // 删除节点及其整棵子树；根节点不能删除
+  void Remove(NodeIndex index) {
+    if (index == kRoot || !IsValid(index))
+      return;
+    Unlink(index);
+    Release(index);
+    if (m_dead_bytes > kArenaChunkSize && m_dead_bytes * 2 > m_arena.StoredBytes())
+      Compact();
+  }
+
+  NodeIndex Find(NodeIndex parent, std::string_view name) const {
+    if (!IsValid(parent) || name.empty())
+      return kNoNode;
+    return Probe(ChildHash(parent, name), [&](const Node &node) { return node.parent == parent && node.name == name; });
+  }
+  NodeIndex FindPath(std::string_view path) const {
+    if (path.empty())
+      return kRoot;
+    return Probe(HashBytes(kHashBasis, path), [&](const Node &node) { return node.path == path; });
+  }
+  // 等价于FindPath(dir + "/" + name)，但不拼接字符串
+  NodeIndex FindPath(std::string_view dir, std::string_view name) const {
+    if (dir.empty())
+      return FindPath(name);
+    const uint64_t hash = HashBytes(HashBytes(HashBytes(kHashBasis, dir), "/"), name);
+    return Probe(hash, [&](const Node &node) {
+      const auto path = node.path;
+      return path.size() == dir.size() + 1 + name.size() && path.compare(0, dir.size(), dir) == 0 &&
+             path[dir.size()] == '/' && path.compare(dir.size() + 1, name.size(), name) == 0;
+    });
+  }
+
+  bool IsValid(NodeIndex index) const {
+    return index < m_nodes.size() && (index == kRoot || m_nodes[index].parent != kNoNode);
+  }
+  bool IsFile(NodeIndex index) const { return !m_nodes[index].filePath.empty(); }
+  std::string_view Name(NodeIndex index) const { return m_nodes[index].name; }
+  std::string_view Path(NodeIndex index) const { return m_nodes[index].path; }
+  std::string_view FilePath(NodeIndex index) const { return m_nodes[index].filePath; }
+  NodeIndex Parent(NodeIndex index) const { return m_nodes[index].parent; }
+  NodeIndex FirstChild(NodeIndex index) const { return m_nodes[index].firstChild; }
+  NodeIndex NextSibling(NodeIndex index) const { return m_nodes[index].nextSibling; }
+  size_t ChildCount(NodeIndex index) const { return m_nodes[index].childCount; }
+
+  size_t NodeCount() const noexcept { return m_live; }
+  size_t MemoryBytes() const noexcept {
+    return m_nodes.capacity() * sizeof(Node) + m_free.capacity() * sizeof(NodeIndex) +
+           m_table.capacity() * sizeof(NodeIndex) + m_arena.ReservedBytes();
+  }
+
+private:
+  struct Node {
+    std::string_view name;     // path的后缀；根节点为根目录名
+    std::string_view path;     // 相对根目录的路径，根为空
+    std::string_view filePath; // 文件的完整路径，目录为空
+    uint64_t hash = 0;         // path的哈希，子节点在此基础上续算
+    NodeIndex parent = kNoNode;
+    NodeIndex firstChild = kNoNode;
+    NodeIndex lastChild = kNoNode;
+    NodeIndex nextSibling = kNoNode;
+    uint32_t childCount = 0;
+  };
+
+  // FNV-1a可以分段续算，(父节点, 名字)不必拼接路径就能得到与完整路径相同的哈希
+  static constexpr uint64_t kHashBasis = 0xcbf29ce484222325ull;
+  static constexpr size_t kMinTableSize = 16;
+  static uint64_t HashBytes(uint64_t hash, std::string_view bytes) {
+    for (unsigned char c : bytes)
+      hash = (hash ^ c) * 0x100000001b3ull;
+    return hash;
+  }
+  uint64_t ChildHash(NodeIndex parent, std::string_view name) const {
+    const uint64_t hash = m_nodes[parent].hash;
+    return HashBytes(parent == kRoot ? hash : HashBytes(hash, "/"), name);
+  }
+
+  template <typename Match> NodeIndex Probe(uint64_t hash, Match &&match) const {
+    const size_t mask = m_table.size() - 1;
+    for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+      const NodeIndex index = m_table[slot];
+      if (index == kNoNode)
+        return kNoNode;
+      if (m_nodes[index].hash == hash && match(m_nodes[index]))
+        return index;
+    }
+  }
+  void InsertSlot(NodeIndex index) {
+    const size_t mask = m_table.size() - 1;
+    size_t slot = m_nodes[index].hash & mask;
+    while (m_table[slot] != kNoNode)
+      slot = (slot + 1) & mask;
+    m_table[slot] = index;
+  }
+  // 线性探测的后移删除：把后续同一探测链上的元素前移，表中不留墓碑
+  void EraseSlot(NodeIndex index) {
+    const size_t mask = m_table.size() - 1;
+    size_t slot = m_nodes[index].hash & mask;
+    while (m_table[slot] != index)
+      slot = (slot + 1) & mask;
+    for (size_t next = (slot + 1) & mask; m_table[next] != kNoNode; next = (next + 1) & mask) {
+      const size_t home = m_nodes[m_table[next]].hash & mask;
+      if (((next - home) & mask) >= ((next - slot) & mask)) {
+        m_table[slot] = m_table[next];
+        slot = next;
+      }
+    }
+    m_table[slot] = kNoNode;
+  }
+  // 负载因子不超过1/2
+  void Grow() {
+    if ((m_live + 1) * 2 <= m_table.size())
+      return;
+    m_table.assign(m_table.size() * 2, kNoNode);
+    for (NodeIndex index = 1; index < m_nodes.size(); ++index) {
+      if (m_nodes[index].parent != kNoNode)
+        InsertSlot(index);
+    }
+  }
+
+  NodeIndex Add(NodeIndex parent, std::string_view name, std::string_view file_path) {
+    if (!IsValid(parent) || IsFile(parent) || name.empty())
+      return kNoNode;
+    const NodeIndex found = Find(parent, name);
+    if (found != kNoNode) {
+      if (IsFile(found) != !file_path.empty())
+        return kNoNode;
+      if (!file_path.empty() && m_nodes[found].filePath != file_path) {
+        m_dead_bytes += m_nodes[found].filePath.size();
+        m_nodes[found].filePath = m_arena.Store(file_path);
+      }
+      return found;
+    }
+    Node node;
+    node.hash = ChildHash(parent, name);
+    node.parent = parent;
+    std::string path(m_nodes[parent].path);
+    if (!path.empty())
+      path += '/';
+    path += name;
+    StoreStrings(node, path, file_path, name.size());
+
+    Grow();
+    NodeIndex index;
+    if (!m_free.empty()) {
+      index = m_free.back();
+      m_free.pop_back();
+      m_nodes[index] = node;
+    } else {
+      index = static_cast<NodeIndex>(m_nodes.size());
+      m_nodes.push_back(node);
+    }
+    // 追加到兄弟链表尾部，保持插入顺序
+    auto &parentNode = m_nodes[parent];
+    if (parentNode.lastChild == kNoNode)
+      parentNode.firstChild = index;
+    else
+      m_nodes[parentNode.lastChild].nextSibling = index;
+    parentNode.lastChild = index;
+    ++parentNode.childCount;
+    InsertSlot(index);
+    ++m_live;
+    return index;
+  }
+
+  // 从父节点的兄弟链表中摘除
+  void Unlink(NodeIndex index) {
+    auto &parentNode = m_nodes[m_nodes[index].parent];
+    NodeIndex prev = kNoNode;
+    for (auto child = parentNode.firstChild; child != index; child = m_nodes[child].nextSibling)
+      prev = child;
+    const NodeIndex next = m_nodes[index].nextSibling;
+    if (prev == kNoNode)
+      parentNode.firstChild = next;
+    else
+      m_nodes[prev].nextSibling = next;
+    if (parentNode.lastChild == index)
+      parentNode.lastChild = prev;
+    --parentNode.childCount;
+  }
+
+  // 完整路径通常以相对路径结尾（<根目录>/FE/FE1.csv），此时相对路径与节点名都指向完整路径的后缀
+  void StoreStrings(Node &node, std::string_view path, std::string_view file_path, size_t name_length) {
+    node.filePath = m_arena.Store(file_path);
+    const size_t prefix = node.filePath.size() - std::min(node.filePath.size(), path.size());
+    const bool shared = prefix > 0 && node.filePath[prefix - 1] == '/' && node.filePath.substr(prefix) == path;
+    node.path = shared ? node.filePath.substr(prefix) : m_arena.Store(path);
+    node.name = node.path.substr(node.path.size() - name_length);
+  }
+
+  // 被删除节点的字符串超过arena一半时，把存活节点的字符串重新紧凑存放；哈希不变，查找表无需重建
+  void Compact() {
+    std::vector<std::string> saved;
+    saved.reserve(m_nodes.size() * 2);
+    for (const auto &node : m_nodes) {
+      saved.emplace_back(node.parent == kNoNode ? node.name : node.path);
+      saved.emplace_back(node.filePath);
+    }
+    m_arena.Rollback(StringArena::Mark{});
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+      auto &node = m_nodes[i];
+      if (i == kRoot)
+        node.name = m_arena.Store(saved[0]);
+      else if (node.parent != kNoNode)
+        StoreStrings(node, saved[2 * i], saved[2 * i + 1], node.name.size());
+    }
+    m_dead_bytes = 0;
+  }
+
+  // 释放整棵子树的槽位，字符串在Compact时回收
+  void Release(NodeIndex index) {
+    for (auto child = m_nodes[index].firstChild; child != kNoNode;) {
+      const NodeIndex next = m_nodes[child].nextSibling;
+      Release(child);
+      child = next;
+    }
+    EraseSlot(index);
+    m_dead_bytes += m_nodes[index].filePath.size() + m_nodes[index].path.size();
+    m_nodes[index] = Node{};
+    m_free.push_back(index);
+    --m_live;
+  }
+
+  static constexpr size_t kArenaChunkSize = 4096; // 配置树的字符串总量通常只有几十KB
+
+  std::vector<Node> m_nodes; // m_nodes[kRoot]为根目录
+  std::vector<NodeIndex> m_free;
+  std::vector<NodeIndex> m_table; // 开放寻址表，槽位存节点下标，空槽为kNoNode
+  size_t m_live = 0;
+  size_t m_dead_bytes = 0; // 已删除节点仍占用的arena字节（估算）
+  StringArena m_arena{kArenaChunkSize};
+};
+
+#endif // CFG_FILE_TREE_HPP
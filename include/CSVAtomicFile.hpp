@@ -0,0 +1,124 @@
+#ifndef CSV_CSVATOMICFILE_HPP
+#define CSV_CSVATOMICFILE_HPP
+
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "ExceptionManager.hpp"
+
+namespace CSVUtils {
+
+// 基于文件描述符的写出端：处理部分写与EINTR，失败抛CSVException
+class FileSink {
+public:
+  FileSink(const std::string &path, int flags) : m_path(path), m_fd(::open(path.c_str(), flags | O_CLOEXEC, 0644)) {
+    if (m_fd < 0)
+      throw ExceptionManager::FileOpenException(path);
+  }
+  FileSink(const FileSink &) = delete;
+  FileSink &operator=(const FileSink &) = delete;
+  ~FileSink() {
+    if (m_fd >= 0)
+      ::close(m_fd);
+  }
+  void Write(std::string_view data) {
+    while (!data.empty()) {
+      ssize_t n = ::write(m_fd, data.data(), data.size());
+      if (n < 0 && errno == EINTR)
+        continue;
+      if (n <= 0)
+        throw ExceptionManager::CSVException("Failed to write file: " + m_path);
+      data.remove_prefix(static_cast<size_t>(n));
+    }
+  }
+  bool EndsWithNewline() const {
+    off_t size = ::lseek(m_fd, 0, SEEK_END);
+    char last = '\n';
+    return size <= 0 || (::pread(m_fd, &last, 1, size - 1) == 1 && last == '\n');
+  }
+  void Sync() {
+    if (::fdatasync(m_fd) != 0)
+      throw ExceptionManager::CSVException("Failed to sync file: " + m_path);
+  }
+  void Close() {
+    if (m_fd >= 0 && ::close(m_fd) != 0) {
+      m_fd = -1;
+      throw ExceptionManager::CSVException("Failed to close file: " + m_path);
+    }
+    m_fd = -1;
+  }
+  int Fd() const noexcept { return m_fd; }
+
+private:
+  std::string m_path;
+  int m_fd = -1;
+};
+
+/**
+ * @brief 原子替换写：内容写入同目录下的独占临时文件，Commit时fdatasync后rename覆盖目标，
+ * 读者与崩溃后的进程只会看到旧文件或完整的新文件；目标已存在时保留其权限与属主。未Commit即析构时删除临时文件
+ */
+class AtomicFile {
+public:
+  explicit AtomicFile(const std::string &path)
+      : m_path(path), m_temp(TempPath(path)), m_sink(m_temp, O_WRONLY | O_CREAT | O_EXCL) {}
+  AtomicFile(const AtomicFile &) = delete;
+  AtomicFile &operator=(const AtomicFile &) = delete;
+  ~AtomicFile() {
+    if (m_committed)
+      return;
+    try {
+      m_sink.Close();
+    } catch (const ExceptionManager::CSVException &) {
+    }
+    ::unlink(m_temp.c_str());
+  }
+
+  FileSink &Sink() { return m_sink; }
+  void Write(std::string_view data) { m_sink.Write(data); }
+  void Commit() {
+    KeepTargetMode();
+    m_sink.Sync();
+    m_sink.Close();
+    if (std::rename(m_temp.c_str(), m_path.c_str()) != 0)
+      throw ExceptionManager::FileOpenException(m_path);
+    m_committed = true;
+  }
+
+private:
+  // 覆盖已有文件时沿用其权限与属主，rename后不会变成临时文件的默认0644
+  void KeepTargetMode() {
+    struct stat target {};
+    if (::stat(m_path.c_str(), &target) != 0)
+      return;
+    if (::fchmod(m_sink.Fd(), target.st_mode & 07777) != 0)
+      throw ExceptionManager::CSVException("Failed to set file mode: " + m_path);
+    struct stat temp {};
+    if (::fstat(m_sink.Fd(), &temp) == 0 && (temp.st_uid != target.st_uid || temp.st_gid != target.st_gid)) {
+      // 非特权进程不能把属主改给他人，失败时保留当前属主
+      [[maybe_unused]] auto chowned = ::fchown(m_sink.Fd(), target.st_uid, target.st_gid);
+    }
+  }
+
+  // 同一进程或多个进程同时写同一目标时各用各的临时文件，互不截断
+  static std::string TempPath(const std::string &path) {
+    static std::atomic<unsigned> counter{0};
+    return path + ".tmp." + std::to_string(::getpid()) + "." + std::to_string(counter.fetch_add(1));
+  }
+
+  std::string m_path;
+  std::string m_temp;
+  FileSink m_sink;
+  bool m_committed = false;
+};
+
+} // namespace CSVUtils
+
+#endif // CSV_CSVATOMICFILE_HPP
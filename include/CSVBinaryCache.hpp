@@ -0,0 +1,340 @@
+#ifndef CSV_CSVBINARYCACHE_HPP
+#define CSV_CSVBINARYCACHE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <sys/stat.h>
+
+#include "CSVAtomicFile.hpp"
+#include "CSVTable.hpp"
+
+namespace CSVUtils {
+
+/**
+ * 二进制解析快照(.csvbin)：放在指定的缓存目录或源CSV旁，保存表头、单元格/行偏移和类型化列。
+ * 单元格文本不重复存储，加载时指向源文件内容（映射区或读入的缓冲区）；源文件的大小、修改时间、内容哈希
+ * 任一不符，或快照本身损坏，都视为失效并回退到完整解析。
+ */
+namespace BinaryCache {
+
+constexpr char kMagic[8] = {'C', 'S', 'V', 'B', 'I', 'N', '\0', '\1'};
+constexpr uint32_t kVersion = 2;
+constexpr uint32_t kEndianTag = 0x01020304;
+
+struct SnapshotHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t endian_tag;
+  uint64_t source_size;
+  int64_t source_mtime;
+  uint64_t source_hash;
+  uint64_t header_count;
+  uint64_t row_count;
+  uint64_t cell_count;
+  uint64_t type_count;
+  uint64_t payload_size;
+  uint64_t payload_hash;
+};
+
+// 单元格在源文件中的位置；源文件超过4GiB时不写快照
+struct CellRef {
+  uint32_t offset;
+  uint32_t length;
+};
+constexpr uint64_t kMaxSourceSize = UINT32_MAX;
+
+inline uint64_t Rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+// 按8字节字长、4路并行的内容哈希，用于判定源文件是否变化及快照完整性
+inline uint64_t HashBytes(std::string_view data) {
+  constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ull;
+  constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4Full;
+  const char *p = data.data();
+  const size_t size = data.size();
+  uint64_t lanes[4] = {kPrime1, kPrime2, ~kPrime1, ~kPrime2};
+  size_t i = 0;
+  for (; i + 32 <= size; i += 32) {
+    for (int lane = 0; lane < 4; ++lane) {
+      uint64_t word;
+      std::memcpy(&word, p + i + lane * 8, 8);
+      lanes[lane] = Rotl(lanes[lane] + word * kPrime2, 31) * kPrime1;
+    }
+  }
+  uint64_t h = Rotl(lanes[0], 1) + Rotl(lanes[1], 7) + Rotl(lanes[2], 12) + Rotl(lanes[3], 18) + size;
+  for (; i < size; i += 8) {
+    uint64_t word = 0;
+    std::memcpy(&word, p + i, std::min<size_t>(8, size - i));
+    h = Rotl(h ^ (word * kPrime2), 27) * kPrime1;
+  }
+  h ^= h >> 33;
+  h *= kPrime2;
+  h ^= h >> 29;
+  return h;
+}
+
+/**
+ * @brief 快照路径：cache_dir为空时放在源文件旁；否则放在cache_dir下，
+ * 文件名带上源文件绝对路径的哈希，不同目录下的同名CSV不会互相覆盖
+ */
+inline std::string SnapshotPath(const std::string &source, const std::string &cache_dir = {}) {
+  std::filesystem::path path(source);
+  if (cache_dir.empty())
+    return path.replace_extension(".csvbin").string();
+  std::error_code ec;
+  auto absolute = std::filesystem::absolute(path, ec);
+  char hash[17];
+  std::snprintf(hash, sizeof(hash), "%016llx",
+                static_cast<unsigned long long>(HashBytes((ec ? path : absolute).lexically_normal().string())));
+  return (std::filesystem::path(cache_dir) / (path.stem().string() + "-" + hash + ".csvbin")).string();
+}
+
+// 源文件的大小与修改时间（纳秒），一次stat取得
+inline bool SourceStamp(const std::string &source, uint64_t &size, int64_t &mtime) {
+  struct stat st {};
+  if (::stat(source.c_str(), &st) != 0)
+    return false;
+  size = static_cast<uint64_t>(st.st_size);
+  mtime = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+  return true;
+}
+
+template <typename T> void AppendPod(std::string &out, const T *data, size_t count) {
+  out.append(reinterpret_cast<const char *>(data), sizeof(T) * count);
+}
+inline void PadTo8(std::string &out) { out.append((8 - out.size() % 8) % 8, '\0'); }
+
+/**
+ * @brief 把表编码为快照映像（头部 + 载荷），不含源文件的修改时间；.csvbin与配置包共用这一格式
+ * 所有单元格与表头必须指向content，否则放弃编码
+ * @return 编码成功返回true，失败不抛异常
+ */
+inline bool EncodeImage(std::string_view content, const std::vector<std::string_view> &header, const CSVTable &table,
+                        std::string &image) {
+  SnapshotHeader info{};
+  std::memcpy(info.magic, kMagic, sizeof(kMagic));
+  info.version = kVersion;
+  info.endian_tag = kEndianTag;
+  info.source_size = content.size();
+  if (content.size() > kMaxSourceSize)
+    return false;
+
+  const char *base = content.data();
+  std::string payload;
+  auto append_cell = [&](std::string_view cell) {
+    if (cell.data() < base || cell.data() + cell.size() > base + content.size())
+      return false;
+    CellRef ref{static_cast<uint32_t>(cell.data() - base), static_cast<uint32_t>(cell.size())};
+    AppendPod(payload, &ref, 1);
+    return true;
+  };
+  payload.reserve((header.size() + table.CellCount()) * sizeof(CellRef) + (table.size() + 1) * sizeof(uint64_t));
+  for (auto name : header) {
+    if (!append_cell(name))
+      return false;
+  }
+  uint64_t offset = 0;
+  AppendPod(payload, &offset, 1);
+  for (auto row : table) {
+    offset += row.size();
+    AppendPod(payload, &offset, 1);
+  }
+  for (auto cell : table.Cells()) {
+    if (!append_cell(cell))
+      return false;
+  }
+  PadTo8(payload);
+  const auto &types = table.ColumnTypes();
+  for (auto type : types) {
+    auto tag = static_cast<uint8_t>(type);
+    AppendPod(payload, &tag, 1);
+  }
+  PadTo8(payload);
+  for (size_t col = 0; col < types.size(); ++col) {
+    if (types[col] == ColumnType::Double) {
+      auto column = table.DoubleColumn(col);
+      AppendPod(payload, column.data(), column.size());
+    } else if (types[col] == ColumnType::UInt32) {
+      auto column = table.UInt32Column(col);
+      AppendPod(payload, column.data(), column.size());
+      PadTo8(payload);
+    }
+  }
+
+  info.source_hash = HashBytes(content);
+  info.header_count = header.size();
+  info.row_count = table.size();
+  info.cell_count = table.CellCount();
+  info.type_count = types.size();
+  info.payload_size = payload.size();
+  info.payload_hash = HashBytes(payload);
+  image.clear();
+  image.reserve(sizeof(info) + payload.size());
+  AppendPod(image, &info, 1);
+  image += payload;
+  return true;
+}
+
+/**
+ * @brief 写快照；所有单元格与表头必须指向content（即源文件内容），否则放弃写入
+ * 与CSVWriter相同，先写临时文件、fdatasync后再改名，崩溃或并发读取都不会看到半个快照
+ * @param cache_dir 快照目录，为空时写在源文件旁；目录不存在时创建
+ * @return 写入成功返回true，失败不抛异常
+ */
+inline bool Write(const std::string &source, std::string_view content, const std::vector<std::string_view> &header,
+                  const CSVTable &table, const std::string &cache_dir = {}) {
+  uint64_t size = 0;
+  int64_t mtime = 0;
+  std::string image;
+  if (!SourceStamp(source, size, mtime) || size != content.size() || !EncodeImage(content, header, table, image))
+    return false;
+  // 记录源文件的修改时间，加载时先比对时间戳再做哈希校验
+  std::memcpy(image.data() + offsetof(SnapshotHeader, source_mtime), &mtime, sizeof(mtime));
+
+  std::error_code ec;
+  if (!cache_dir.empty())
+    std::filesystem::create_directories(cache_dir, ec);
+  try {
+    AtomicFile file(SnapshotPath(source, cache_dir));
+    file.Write(image);
+    file.Commit();
+  } catch (const ExceptionManager::CSVException &) {
+    return false;
+  }
+  return true;
+}
+
+// 带边界检查的顺序读取游标
+class SnapshotCursor {
+public:
+  explicit SnapshotCursor(std::string_view data) : m_data(data) {}
+  template <typename T> bool Read(T *out, size_t count) {
+    const size_t bytes = sizeof(T) * count;
+    if (count > m_data.size() / sizeof(T) || bytes > m_data.size() - m_pos)
+      return false;
+    std::memcpy(out, m_data.data() + m_pos, bytes);
+    m_pos += bytes;
+    return true;
+  }
+  bool AlignTo8() {
+    m_pos += (8 - m_pos % 8) % 8;
+    return m_pos <= m_data.size();
+  }
+  bool AtEnd() const { return m_pos == m_data.size(); }
+
+private:
+  std::string_view m_data;
+  size_t m_pos = 0;
+};
+
+// 快照的源文件时间戳是否与source当前一致；快照过短时返回false
+inline bool MatchesSource(const std::string &source, std::string_view snapshot) {
+  SnapshotHeader info{};
+  if (snapshot.size() < sizeof(info))
+    return false;
+  std::memcpy(&info, snapshot.data(), sizeof(info));
+  uint64_t size = 0;
+  int64_t mtime = 0;
+  return SourceStamp(source, size, mtime) && size == info.source_size && mtime == info.source_mtime;
+}
+
+/**
+ * @brief 校验并解码快照映像，不检查源文件时间戳
+ * @param content 源文件内容（通常为映射区），恢复出的单元格指向这里
+ * @param snapshot 快照映像（通常为映射区），读取完成后即可释放
+ * @return 映像有效时填充header/table并返回true；与content不符或损坏返回false，不抛异常
+ */
+inline bool DecodeImage(std::string_view content, std::string_view snapshot, std::vector<std::string_view> &header,
+                        CSVTable &table) {
+  SnapshotHeader info{};
+  if (snapshot.size() < sizeof(info))
+    return false;
+  std::memcpy(&info, snapshot.data(), sizeof(info));
+  if (std::memcmp(info.magic, kMagic, sizeof(kMagic)) != 0 || info.version != kVersion ||
+      info.endian_tag != kEndianTag || content.size() != info.source_size)
+    return false;
+  std::string_view payload = snapshot.substr(sizeof(info));
+  if (payload.size() != info.payload_size || HashBytes(payload) != info.payload_hash ||
+      HashBytes(content) != info.source_hash)
+    return false;
+  if (info.cell_count > payload.size() / sizeof(CellRef) || info.row_count >= payload.size() / sizeof(uint64_t))
+    return false;
+
+  SnapshotCursor cursor(payload);
+  auto read_cells = [&](uint64_t count, auto &&sink) {
+    CellRef ref{};
+    for (uint64_t i = 0; i < count; ++i) {
+      if (!cursor.Read(&ref, 1) || ref.offset > content.size() || ref.length > content.size() - ref.offset)
+        return false;
+      sink(content.substr(ref.offset, ref.length));
+    }
+    return true;
+  };
+  std::vector<std::string_view> names;
+  if (!read_cells(info.header_count, [&](std::string_view name) { names.push_back(name); }))
+    return false;
+  std::vector<uint64_t> offsets(info.row_count + 1);
+  if (!cursor.Read(offsets.data(), offsets.size()) || offsets.front() != 0 || offsets.back() != info.cell_count)
+    return false;
+  CSVTable restored;
+  restored.Reserve(info.row_count, info.cell_count);
+  for (uint64_t row = 0; row < info.row_count; ++row) {
+    if (offsets[row + 1] < offsets[row] ||
+        !read_cells(offsets[row + 1] - offsets[row], [&](std::string_view cell) { restored.AppendCell(cell); }))
+      return false;
+    restored.FinishRow();
+  }
+  if (!cursor.AlignTo8())
+    return false;
+  std::vector<uint8_t> tags(info.type_count);
+  if (!cursor.Read(tags.data(), tags.size()) || !cursor.AlignTo8())
+    return false;
+  std::vector<ColumnType> types;
+  std::vector<CSVTable::TypedColumn> columns(tags.size());
+  for (size_t col = 0; col < tags.size(); ++col) {
+    if (tags[col] > static_cast<uint8_t>(ColumnType::Dictionary))
+      return false;
+    types.push_back(static_cast<ColumnType>(tags[col]));
+    if (types.back() == ColumnType::Double) {
+      columns[col].doubles.resize(info.row_count);
+      if (!cursor.Read(columns[col].doubles.data(), info.row_count))
+        return false;
+    } else if (types.back() == ColumnType::UInt32) {
+      columns[col].uints.resize(info.row_count);
+      if (!cursor.Read(columns[col].uints.data(), info.row_count) || !cursor.AlignTo8())
+        return false;
+    }
+  }
+  if (!cursor.AtEnd())
+    return false;
+  // Dictionary列不落盘，恢复时由单元格重新编码
+  try {
+    if (!types.empty())
+      restored.RestoreColumnTypes(std::move(types), std::move(columns));
+  } catch (const ExceptionManager::CSVException &) {
+    return false;
+  }
+  header = std::move(names);
+  table = std::move(restored);
+  return true;
+}
+
+// 校验时间戳后解码.csvbin快照
+inline bool Read(const std::string &source, std::string_view content, std::string_view snapshot,
+                 std::vector<std::string_view> &header, CSVTable &table) {
+  return MatchesSource(source, snapshot) && DecodeImage(content, snapshot, header, table);
+}
+
+} // namespace BinaryCache
+
+} // namespace CSVUtils
+
+#endif // CSV_CSVBINARYCACHE_HPP
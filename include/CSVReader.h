@@ -5,12 +5,17 @@
 #ifndef CSV_CSVREADER_H
 #define CSV_CSVREADER_H
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <cstring>
 #include <fstream>
 #include <future>
 #include <initializer_list>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <set>
 #include <sstream>
 #include <string>
@@ -18,11 +23,69 @@
 #include <thread>
 #include <vector>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "CSVBinaryCache.hpp"
+#include "CSVScanner.hpp"
+#include "CSVTable.hpp"
+#include "CSVWriter.hpp"
 #include "ExceptionManager.hpp"
+#include "ThreadPool.hpp"
+
+// 只读文件映射，析构时解除映射
+class MemoryMap {
+public:
+  explicit MemoryMap(const std::string &filename) {
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+      throw ExceptionManager::FileOpenException(filename);
+    struct stat st {};
+    if (::fstat(fd, &st) != 0) {
+      ::close(fd);
+      throw ExceptionManager::FileOpenException(filename);
+    }
+    m_size = static_cast<size_t>(st.st_size);
+    if (m_size > 0) {
+      void *addr = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (addr == MAP_FAILED) {
+        ::close(fd);
+        throw ExceptionManager::FileOpenException(filename);
+      }
+      m_data = static_cast<const char *>(addr);
+    }
+    ::close(fd); // 映射建立后即可关闭fd
+  }
+  MemoryMap(const MemoryMap &) = delete;
+  MemoryMap &operator=(const MemoryMap &) = delete;
+  ~MemoryMap() {
+    if (m_data)
+      ::munmap(const_cast<char *>(m_data), m_size);
+  }
+  // 解析期间顺序扫描，提示内核预读
+  void AdviseSequential() const { Advise(MADV_SEQUENTIAL | MADV_WILLNEED); }
+  // 解析完成后转为随机查询访问
+  void AdviseNormal() const { Advise(MADV_NORMAL); }
+  std::string_view View() const { return {m_data, m_size}; }
+  size_t Size() const { return m_size; }
+
+private:
+  void Advise(int advice) const {
+    if (m_data)
+      ::madvise(const_cast<char *>(m_data), m_size, advice);
+  }
+
+  const char *m_data = nullptr;
+  size_t m_size = 0;
+};
 
 class BaseIO {
 public:
   virtual size_t Read(char *buffer, size_t size) = 0;
+  // 支持零拷贝的后端返回其映射，其余后端返回nullptr
+  virtual std::shared_ptr<const MemoryMap> GetMapping() const { return nullptr; }
   virtual ~BaseIO() {}
 };
 
@@ -38,6 +101,22 @@ private:
   std::istream &m_stream;
 };
 
+class MappedFileIO : public BaseIO {
+public:
+  explicit MappedFileIO(std::shared_ptr<const MemoryMap> mapping) : m_mapping(std::move(mapping)) {}
+  size_t Read(char *buffer, size_t size) override {
+    auto view = m_mapping->View().substr(m_offset, size);
+    std::copy(view.begin(), view.end(), buffer);
+    m_offset += view.size();
+    return view.size();
+  }
+  std::shared_ptr<const MemoryMap> GetMapping() const override { return m_mapping; }
+
+private:
+  std::shared_ptr<const MemoryMap> m_mapping;
+  size_t m_offset = 0;
+};
+
 namespace CSVUtils {
 
 namespace FileOperations {
@@ -58,25 +137,19 @@ bool CheckFileExtension(const std::string &filename, const std::string &extensio
 }; // namespace FileOperations
 
 namespace ParseOperations {
-std::vector<std::string_view> SplitRow(std::string_view str, const char &ch) {
+std::vector<std::string_view> SplitRow(std::string_view str, const char &ch, size_t reserve_hint = 0) {
   std::vector<std::string_view> tmp;
-  tmp.reserve(str.size() / 2); // 预分配内存
-  size_t start = 0;
-  for (size_t pos = 0; pos < str.size(); ++pos) {
-    if (str[pos] == ch || (str[pos] == '\r' && pos + 1 < str.size() && str[pos + 1] == '\n')) {
-      if (pos - start > 0)
-        tmp.emplace_back(str.substr(start, pos - start)); // 插入子串
-      if (str[pos] == ch || (str[pos] == '\r' && str[pos + 1] == '\n')) {
-        start = pos + (str[pos] == '\r' ? 2 : 1);
-        ++pos; // 如果遇到'\r\n'，跳过下一个'\n'
-      }
-    }
-  }
-  if (start < str.size())
-    tmp.emplace_back(str.substr(start, str.size() - start)); // 插入子串
+  // 未给出列数提示时按开头样本估算字段数预留，整段只扫描一遍
+  tmp.reserve(reserve_hint ? reserve_hint : Scanner::EstimateCandidates(str, ch) + 1);
+  Scanner::ForEachField(str, ch, [&tmp](std::string_view field) { tmp.emplace_back(field); });
   return tmp;
 }
 
+// 不经过临时vector，直接把每个单元格交给回调
+template <typename Fn> void ForEachColumn(std::string_view row, Fn &&fn) {
+  Scanner::ForEachField(row, ',', std::forward<Fn>(fn));
+}
+
 std::string_view SplitFirstRow(std::string_view str, const char &ch) {
   auto pos = str.find_first_of(ch);
   return str.substr(0, pos);
@@ -126,6 +199,9 @@ public:
   std::unique_ptr<BaseIO> CreateFileHandler() {
     return FileOperations::OpenFileHandle(m_fileHandle->GetHandle());
   }
+  std::unique_ptr<BaseIO> CreateMappedFileHandler() {
+    return std::make_unique<MappedFileIO>(std::make_shared<MemoryMap>(GetFileName()));
+  }
   size_t GetFileSize() const { return m_file_size; }
   std::string GetFileName() const { return m_fileHandle->GetHandleContext(); }
 
@@ -143,9 +219,21 @@ private:
   std::unique_ptr<FileHandle> m_fileHandle = nullptr;
 };
 
-using OperateStrategyCallback = std::function<void(std::vector<std::vector<std::string_view>> &)>;
-using QueryStrategyCallback = std::function<std::vector<std::string_view>(
-    const std::vector<std::vector<std::string_view>> &)>;
+using OperateStrategyCallback = std::function<void(CSVTable &)>;
+using QueryStrategyCallback = std::function<std::vector<std::string_view>(const CSVTable &)>;
+
+// 最近一次解析的分阶段记录，通过CSVParser::GetParseProfile取得
+struct ParseProfile {
+  enum class Source { File, Snapshot, Image }; // 解析源文件 / 加载.csvbin快照 / 加载配置包映像
+  Source source = Source::File;
+  size_t bytes = 0; // 源内容字节数
+  size_t rows = 0;
+  size_t cells = 0;        // Lazy模式下行尚未切分，为0
+  double io_ms = 0;        // 读入或映射文件并解析表头；快照与映像为映射、校验与解码；含写快照
+  double split_ms = 0;     // 行与单元格切分，含逐行列数校验
+  double validate_ms = 0;  // 按schema转换并校验类型化列
+  size_t estimated_peak_bytes = 0; // 估算：解析期间同时存在的读缓冲区、行索引与表结构之和，不含映射区
+};
 
 class ParserImpl {
 public:
@@ -153,109 +241,571 @@ public:
   void SetColumnNames(const std::vector<std::string_view> &column_names) {
     m_column_names = column_names;
   }
+  void SetColumnSchema(ColumnSchema schema) { m_schema = std::move(schema); }
+  void SetProjection(std::vector<std::string> columns) { m_projection = std::move(columns); }
+  bool HasProjection() const { return !m_projection.empty(); }
+  void ResetProfile() { m_profile = ParseProfile(); }
+  const ParseProfile &GetProfile() const { return m_profile; }
+  // 读入（或映射）整个文件并解析表头
+  void LoadBuffer(const std::unique_ptr<BaseIO> &io, const size_t &size) {
+    const auto start = std::chrono::steady_clock::now();
+    m_mapping = io->GetMapping();
+    if (m_mapping) {
+      // 零拷贝：行与单元格直接指向映射区，映射随解析器存活
+      m_read_buffer.reset();
+      m_buffer = m_mapping->View();
+      m_mapping->AdviseSequential();
+    } else {
+      // 每次解析分配新缓冲区，已通过GetSourceBuffer交出的旧缓冲区不受影响
+      auto buffer = std::make_shared<std::string>(size, '\0');
+      io->Read(buffer->data(), size);
+      m_read_buffer = std::move(buffer);
+      m_buffer = *m_read_buffer;
+    }
+    // 上一次解析失败（如类型转换出错）时表中可能残留已切分的行，重新解析从空表开始
+    m_csv_data = CSVTable();
+    ParseHeader();
+    ResolveProjection();
+    m_profile.source = ParseProfile::Source::File;
+    m_profile.bytes = m_buffer.size();
+    m_profile.io_ms += ElapsedMs(start);
+    NoteEstimatedPeakBytes(0);
+  }
   void ParseRows(const std::unique_ptr<BaseIO> &io, const size_t &size) {
-    m_read_buffer.resize(size);
-    io->Read(m_read_buffer.data(), size);
-    m_rows = ParseOperations::SplitRowSkipHeader(m_read_buffer, '\n');
+    LoadBuffer(io, size);
+    const auto start = std::chrono::steady_clock::now();
+    m_rows = ParseOperations::SplitRowSkipHeader(m_buffer, '\n');
+    m_profile.split_ms += ElapsedMs(start);
+    NoteEstimatedPeakBytes(0);
   }
-  void ParseColumns(const std::vector<std::string_view> &rows) {
-    // m_csv_data.resize(rows.size());
-    m_csv_data.reserve(rows.size());
-    size_t current_line_number = 1;
-    for (size_t i = 0; i < rows.size(); ++i) {
-      current_line_number += i;
-      auto columns = ParseOperations::SplitRow(rows[i], ',');
-      // column size一致性校验
-      if (!m_column_names.empty() && !ValidateColumnCount(columns)) {
-        throw ExceptionManager::InvalidDataLine(current_line_number, "Invalid columns");
+  /**
+   * @brief 尝试从二进制快照恢复，快照失效、损坏或与当前列配置不符时返回false
+   * @param map_source 为true时单元格指向源文件的映射（与MemoryMapped模式相同，源文件只能整体替换）；
+   *        否则与完整解析一样把源内容读入自有缓冲区，之后原地改写源文件不影响已加载的数据
+   */
+  bool LoadSnapshot(const std::string &source, const std::string &cache_dir, bool map_source) {
+    // 快照保存的是完整表，投影解析不使用快照
+    if (HasProjection())
+      return false;
+    const auto start = std::chrono::steady_clock::now();
+    std::shared_ptr<const MemoryMap> mapping, snapshot;
+    std::shared_ptr<std::string> buffer;
+    try {
+      snapshot = std::make_shared<MemoryMap>(BinaryCache::SnapshotPath(source, cache_dir));
+      if (!BinaryCache::MatchesSource(source, snapshot->View())) {
+        m_profile.io_ms += ElapsedMs(start);
+        return false;
+      }
+      if (map_source) {
+        mapping = std::make_shared<MemoryMap>(source);
+      } else {
+        FileManager file(source);
+        buffer = std::make_shared<std::string>(file.GetFileSize(), '\0');
+        buffer->resize(file.CreateFileHandler()->Read(buffer->data(), buffer->size()));
       }
-      m_csv_data.emplace_back(columns);
-      // m_csv_data[i] = columns;
+    } catch (const ExceptionManager::CSVException &) {
+      m_profile.io_ms += ElapsedMs(start);
+      return false;
     }
+    m_profile.io_ms += ElapsedMs(start);
+    // 读取期间源文件被改写时，内容哈希与快照不符，回退到完整解析
+    std::string_view content = mapping ? mapping->View() : std::string_view(*buffer);
+    if (!RestoreImage(std::move(mapping), std::move(buffer), content, snapshot->View()))
+      return false;
+    m_profile.source = ParseProfile::Source::Snapshot;
+    return true;
   }
-  void AsyncParseColumns(const std::vector<std::string_view> &rows, size_t thread_nums) {
-    std::vector<std::thread> threads; // 创建一个线程向量，存储多个线程
-    std::atomic<size_t> counter(0); //创建一个原子计数器，用于记录当前处理的行数
-    m_csv_data.resize(rows.size()); // 一维数组的size初始化二维数组的size
-
-    auto CheckAndSplitRow2Columns = [this, &rows](size_t j) {
-      auto columns = CSVUtils::ParseOperations::SplitRow(rows.at(j), ',');
-      if (!m_column_names.empty() && !ValidateColumnCount(columns)) {
-        throw ExceptionManager::InvalidDataLine(j, "Invalid columns");
-      }
-      return std::vector(columns);
-    };
-    for (size_t i = 0; i < thread_nums; ++i) {
-      threads.emplace_back([this, &counter, &CheckAndSplitRow2Columns, &rows] {
-        while (true) {
-          size_t j = counter.fetch_add(1);
-          if (j >= rows.size())
-            break;
-          m_csv_data[j] = CheckAndSplitRow2Columns(j);
-        }
-      });
+  /**
+   * @brief 从快照映像恢复，content为mapping中的一段（如配置包中的一个文件），单元格指向content
+   * 映像损坏或与当前列配置不符时返回false
+   */
+  bool LoadImage(std::shared_ptr<const MemoryMap> mapping, std::string_view content, std::string_view image) {
+    return RestoreImage(std::move(mapping), nullptr, content, image);
+  }
+  // 单元格指向content，content位于mapping或buffer之中，二者随解析结果一起保活
+  bool RestoreImage(std::shared_ptr<const MemoryMap> mapping, std::shared_ptr<std::string> buffer,
+                    std::string_view content, std::string_view image) {
+    if (HasProjection())
+      return false;
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::string_view> header;
+    CSVTable table;
+    const bool decoded = BinaryCache::DecodeImage(content, image, header, table);
+    m_profile.io_ms += ElapsedMs(start);
+    if (!decoded)
+      return false;
+    // 快照的列类型与每行列数须与当前配置一致
+    std::swap(m_header_names, header);
+    ResolveProjection();
+    std::vector<ColumnType> expected;
+    try {
+      if (!m_schema.empty())
+        expected = ResolveColumnTypes();
+    } catch (const ExceptionManager::CSVException &) {
+      std::swap(m_header_names, header);
+      return false;
     }
-    // 监听线程的完成情况
-    for (auto &t : threads) {
-      t.join();
+    bool rows_valid = m_column_names.empty() || std::all_of(table.begin(), table.end(), [this](const auto &row) {
+                        return row.size() == m_column_names.size();
+                      });
+    if (expected != table.ColumnTypes() || !rows_valid) {
+      std::swap(m_header_names, header);
+      return false;
     }
+    m_read_buffer = std::move(buffer);
+    m_mapping = std::move(mapping);
+    m_buffer = content;
+    m_rows.clear();
+    m_csv_data = std::move(table);
+    m_persisted_rows = m_csv_data.size();
+    m_profile.source = ParseProfile::Source::Image;
+    m_profile.bytes = content.size();
+    m_profile.rows = m_csv_data.size();
+    m_profile.cells = m_csv_data.CellCount();
+    NoteEstimatedPeakBytes(0);
+    return true;
+  }
+  // 解析后写二进制快照，失败时静默放弃
+  bool WriteSnapshot(const std::string &source, const std::string &cache_dir) {
+    if (HasProjection() || m_lazy)
+      return false;
+    const auto start = std::chrono::steady_clock::now();
+    const bool written = BinaryCache::Write(source, m_buffer, m_header_names, m_csv_data, cache_dir);
+    m_profile.io_ms += ElapsedMs(start);
+    return written;
+  }
+  // 把源内容与解析结果导出为快照映像，供打包使用
+  bool ExportImage(std::string &content, std::string &image) const {
+    if (HasProjection() || m_lazy || !BinaryCache::EncodeImage(m_buffer, m_header_names, m_csv_data, image))
+      return false;
+    content.assign(m_buffer);
+    return true;
+  }
+  // 解析结束：按schema一次性转换数值列，映射区转为查询访问模式
+  void FinishParse() {
+    const auto start = std::chrono::steady_clock::now();
+    if (!m_schema.empty())
+      m_csv_data.BindColumnTypes(ResolveColumnTypes());
+    m_profile.validate_ms += ElapsedMs(start);
+    if (m_mapping)
+      m_mapping->AdviseNormal();
+    m_persisted_rows = m_csv_data.size();
+    m_profile.rows = m_csv_data.size();
+    m_profile.cells = m_csv_data.CellCount();
+    NoteEstimatedPeakBytes(0);
+  }
+  /**
+   * @brief 懒切分：只保留ParseRows得到的行索引，行在首次访问时才切分成单元格
+   * 需在FinishParse之后调用；整表访问（GetCSVData、写文件、增删改回调）会一次性切分剩余行
+   */
+  void BuildLazyIndex() {
+    std::lock_guard<std::mutex> lock(m_lazy_mutex);
+    m_lazy_rows.Reset(m_rows.size());
+    m_lazy.store(true, std::memory_order_release);
+    m_persisted_rows = m_rows.size();
+    m_profile.rows = m_rows.size();
+  }
+  /**
+   * @brief 按行号取一行，可由多个线程并发调用：已切分的行无锁读取，首次切分在m_lazy_mutex下进行
+   * 返回的行视图在下一次重新解析之前有效，中途整表切分（GetCSVData等）不会使其失效
+   */
+  CSVTable::RowView GetRow(size_t row) {
+    if (!m_lazy.load(std::memory_order_acquire))
+      return m_csv_data[row];
+    if (m_lazy_rows.Has(row))
+      return m_lazy_rows.Get(row);
+    std::lock_guard<std::mutex> lock(m_lazy_mutex);
+    if (!m_lazy.load(std::memory_order_relaxed))
+      return m_csv_data[row];
+    if (m_lazy_rows.Has(row))
+      return m_lazy_rows.Get(row);
+    m_split_scratch.Clear();
+    const size_t columns = AppendProjectedRow(m_rows[row], m_split_scratch);
+    const size_t expected = ExpectedColumnCount();
+    if (expected != 0 && columns != expected)
+      throw ExceptionManager::InvalidDataLine(row + 2, "Invalid columns");
+    return m_lazy_rows.Store(row, m_split_scratch.Cells());
+  }
+  LazyTableStats GetLazyStats() const {
+    std::lock_guard<std::mutex> lock(m_lazy_mutex);
+    if (m_lazy.load(std::memory_order_relaxed))
+      return m_lazy_rows.Stats(sizeof(std::string_view));
+    LazyTableStats stats;
+    stats.rows = stats.materialized_rows = m_csv_data.size();
+    stats.materialized_bytes = m_csv_data.CellCount() * sizeof(CSVTable::Cell) + (m_csv_data.size() + 1) * sizeof(size_t);
+    return stats;
+  }
+  void ParseColumns(const std::vector<std::string_view> &rows) {
+    const auto start = std::chrono::steady_clock::now();
+    SplitColumns(rows, m_csv_data);
+    m_profile.split_ms += ElapsedMs(start);
+    NoteEstimatedPeakBytes(0);
+  }
+  /**
+   * @brief 将表头之后的数据按换行对齐切成若干字节区间，每个线程独立完成区间内的行、列切分，
+   *        结果写入线程私有的段，最后按顺序拼接；无逐行原子计数，也无串行的行切分
+   */
+  void AsyncParseRanges(ThreadPool &pool) {
+    const auto start = std::chrono::steady_clock::now();
+    const auto ranges = PartitionByNewline(SkipHeader(m_buffer), pool.Size());
+    std::vector<RangeSegment> segments(ranges.size());
+    pool.ParallelFor(ranges.size(), [this, &ranges, &segments](size_t i) { ParseRange(ranges[i], segments[i]); });
+    JoinSegments(segments);
+    m_profile.split_ms += ElapsedMs(start);
+    // 拼接时各段与合并后的表同时存在
+    size_t segment_bytes = 0;
+    for (const auto &segment : segments)
+      segment_bytes += segment.table.MemoryBytes();
+    NoteEstimatedPeakBytes(segment_bytes);
   }
+  // 整表写回，首行为表中实际保存的列名（投影时只含投影列）
   void WriteToFile(const std::string &des_file_path) {
-    std::ofstream ofs(des_file_path, std::ios::out);
-    if (!ofs.is_open()) {
-      throw ExceptionManager::FileOpenException(des_file_path);
-    }
-    // 先写首行
-    for (const auto &column_name : m_column_names) {
-      ofs << column_name;
-      if (&column_name != &m_column_names.back()) {
-        ofs << ",";
-      }
-    }
-    ofs << std::endl;
-    // 写数据
-    for (const auto &row : m_csv_data) {
-      for (size_t i = 0; i < row.size(); ++i) {
-        ofs << row[i];
-        if (i != row.size() - 1) {
-          ofs << ",";
-        }
-      }
-      ofs << std::endl;
+    MaterializeLazyRows();
+    CSVWriter writer;
+    writer.WriteTable(des_file_path, m_table_names, m_csv_data);
+    m_persisted_rows = m_csv_data.size();
+  }
+  /**
+   * @brief 只追加上次解析/写出之后新增的行（如拟合行）；行数少于已落盘行数说明发生过删除，改为整表重写
+   */
+  void AppendToFile(const std::string &des_file_path) {
+    if (HasProjection())
+      throw ExceptionManager::CSVException("Cannot append projected rows to " + des_file_path);
+    MaterializeLazyRows();
+    if (m_csv_data.size() < m_persisted_rows) {
+      WriteToFile(des_file_path);
+      return;
     }
-    ofs.close();
+    CSVWriter writer;
+    writer.AppendRows(des_file_path, m_csv_data, m_persisted_rows);
+    m_persisted_rows = m_csv_data.size();
   }
   void OnOperationCallback(OperateStrategyCallback onOperateStrategy) {
+    MaterializeLazyRows();
     if (onOperateStrategy)
       onOperateStrategy(m_csv_data);
   }
   std::vector<std::string_view> OnQueryCallback(QueryStrategyCallback onQueryStrategy) {
+    MaterializeLazyRows();
     if (onQueryStrategy)
       return onQueryStrategy(m_csv_data);
     return std::vector<std::string_view>();
   }
-  std::vector<std::vector<std::string_view>> GetCSVData() const { return m_csv_data; }
-  size_t GetDataSize() const { return m_csv_data.size(); }
-  std::vector<std::string_view> GetRowData() const { return m_rows; }
+  const CSVTable &GetCSVData() {
+    MaterializeLazyRows();
+    return m_csv_data;
+  }
+  size_t GetDataSize() const {
+    return m_lazy.load(std::memory_order_acquire) ? m_rows.size() : m_csv_data.size();
+  }
+  // 表中单元格指向的缓冲区（读入的文件内容或映射），持有它即可让单元格在解析器之外保持有效
+  std::shared_ptr<const void> GetSourceBuffer() const {
+    if (m_mapping)
+      return m_mapping;
+    return m_read_buffer;
+  }
+  // 移出解析结果，解析器中的表随之清空
+  CSVTable TakeCSVData() {
+    MaterializeLazyRows();
+    CSVTable table = std::move(m_csv_data);
+    m_csv_data = CSVTable();
+    m_persisted_rows = 0;
+    return table;
+  }
+  const std::vector<std::string_view> &GetRowData() const { return m_rows; }
   const std::vector<std::string_view> &GetColumnNames() const { return m_column_names; }
+  const std::vector<std::string_view> &GetHeaderNames() const { return m_header_names; }
+  const std::vector<std::string_view> &GetTableColumnNames() const { return m_table_names; }
 
 private:
-  bool ValidateColumnCount(const std::vector<std::string_view> &columns) {
-    return columns.size() == m_column_names.size();
+  // 线程私有的解析结果；bad_row记录区间内首个列数不符的行
+  struct RangeSegment {
+    CSVTable table;
+    std::optional<size_t> bad_row;
+  };
+  static constexpr size_t kMinRangeBytes = 64 * 1024; // 小于该值的区间不再细分
+
+  static std::string_view SkipHeader(std::string_view buffer) {
+    auto pos = buffer.find('\n');
+    return pos == std::string_view::npos ? std::string_view() : buffer.substr(pos + 1);
+  }
+  // 按字节均分后把每个边界推进到下一个换行之后，保证区间只含完整的行
+  static std::vector<std::string_view> PartitionByNewline(std::string_view body, size_t parts) {
+    parts = std::clamp<size_t>(body.size() / kMinRangeBytes, 1, std::max<size_t>(parts, 1));
+    std::vector<std::string_view> ranges;
+    ranges.reserve(parts);
+    size_t begin = 0;
+    for (size_t i = 1; i <= parts && begin < body.size(); ++i) {
+      size_t end = i == parts ? body.size() : std::max(begin, body.size() * i / parts);
+      if (end < body.size()) {
+        end = body.find('\n', end);
+        end = end == std::string_view::npos ? body.size() : end + 1;
+      }
+      ranges.push_back(body.substr(begin, end - begin));
+      begin = end;
+    }
+    return ranges;
+  }
+  void ParseRange(std::string_view range, RangeSegment &segment) const {
+    auto &table = segment.table;
+    const size_t expected = ExpectedColumnCount();
+    Scanner::ForEachField(range, '\n', [&](std::string_view row) {
+      if (segment.bad_row)
+        return;
+      const size_t columns = AppendProjectedRow(row, table);
+      if (expected != 0 && columns != expected) {
+        table.DiscardPendingRow();
+        segment.bad_row = table.size();
+        return;
+      }
+      table.FinishRow();
+    });
+  }
+  void JoinSegments(const std::vector<RangeSegment> &segments) {
+    size_t rows = 0, cells = 0;
+    for (const auto &segment : segments) {
+      if (segment.bad_row) {
+        // 之前的段均已完整解析，行号可直接累加；首行为表头
+        throw ExceptionManager::InvalidDataLine(rows + *segment.bad_row + 2, "Invalid columns");
+      }
+      rows += segment.table.size();
+      cells += segment.table.CellCount();
+    }
+    m_csv_data.Reserve(m_csv_data.size() + rows, m_csv_data.CellCount() + cells);
+    for (const auto &segment : segments) {
+      m_csv_data.Append(segment.table);
+    }
+  }
+  // 切分各行的单元格并校验列数；解析与退出懒切分共用
+  void SplitColumns(const std::vector<std::string_view> &rows, CSVTable &table) const {
+    const size_t expected = ExpectedColumnCount();
+    table.Reserve(table.size() + rows.size(), table.CellCount() + rows.size() * m_table_names.size());
+    for (size_t i = 0; i < rows.size(); ++i) {
+      const size_t columns = AppendProjectedRow(rows[i], table);
+      // column size一致性校验，首行为表头，数据从第2行开始
+      if (expected != 0 && columns != expected) {
+        table.DiscardPendingRow();
+        throw ExceptionManager::InvalidDataLine(i + 2, "Invalid columns");
+      }
+      table.FinishRow();
+    }
+  }
+  /**
+   * @brief 退出懒切分：切分全部行到m_csv_data（类型化列在FinishRow时转换）；不计入解析记录
+   * 行缓存保留到下一次解析，其他线程此前从GetRow取得的行视图仍然有效
+   */
+  void MaterializeLazyRows() {
+    if (!m_lazy.load(std::memory_order_acquire))
+      return;
+    std::lock_guard<std::mutex> lock(m_lazy_mutex);
+    if (!m_lazy.load(std::memory_order_relaxed))
+      return;
+    // 先切分到临时表，中途失败（列数不符、数值无效）时m_csv_data与懒切分状态保持不变，可以重试
+    CSVTable table;
+    if (!m_csv_data.ColumnTypes().empty())
+      table.BindColumnTypes(m_csv_data.ColumnTypes());
+    SplitColumns(m_rows, table);
+    m_csv_data = std::move(table);
+    m_lazy.store(false, std::memory_order_release);
+  }
+  static double ElapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  }
+  // 按当前读缓冲区、行索引与表的容量更新峰值，extra为调用方另外持有的临时结构
+  void NoteEstimatedPeakBytes(size_t extra) {
+    const size_t bytes = (m_read_buffer ? m_read_buffer->capacity() : 0) +
+                         m_rows.capacity() * sizeof(std::string_view) + m_csv_data.MemoryBytes() + extra;
+    m_profile.estimated_peak_bytes = std::max(m_profile.estimated_peak_bytes, bytes);
+  }
+  void ParseHeader() {
+    m_header_names.clear();
+    auto header = ParseOperations::SplitFirstRow(m_buffer, '\n');
+    if (!header.empty() && header.back() == '\r')
+      header.remove_suffix(1);
+    ParseOperations::ForEachColumn(header, [this](std::string_view name) { m_header_names.push_back(name); });
+  }
+  /**
+   * @brief 按列名确定要保存的列；列名优先取SetColumnNames设置的名称，否则取文件表头
+   * 投影列按源文件中的顺序保存，表中的列序号以此为准
+   */
+  void ResolveProjection() {
+    const auto &names = m_column_names.empty() ? m_header_names : m_column_names;
+    m_projection_mask.clear();
+    if (!HasProjection()) {
+      m_table_names = names;
+      return;
+    }
+    m_projection_mask.assign(names.size(), 0);
+    for (const auto &column : m_projection) {
+      auto it = std::find(names.begin(), names.end(), column);
+      if (it == names.end())
+        throw ExceptionManager::InvalidHeaderLine("Unknown column in projection: " + column);
+      m_projection_mask[it - names.begin()] = 1;
+    }
+    m_table_names.clear();
+    for (size_t col = 0; col < names.size(); ++col) {
+      if (m_projection_mask[col])
+        m_table_names.push_back(names[col]);
+    }
+  }
+  // 每行应有的总列数，0表示不校验；投影时总按表头校验，保证跳过的列也不缺失
+  size_t ExpectedColumnCount() const {
+    if (!m_column_names.empty())
+      return m_column_names.size();
+    return HasProjection() ? m_header_names.size() : 0;
+  }
+  // 切分一行，只追加投影列的单元格（无投影时全部追加），返回该行的总列数
+  size_t AppendProjectedRow(std::string_view row, CSVTable &table) const {
+    size_t col = 0;
+    if (m_projection_mask.empty()) {
+      ParseOperations::ForEachColumn(row, [&](std::string_view cell) {
+        table.AppendCell(cell);
+        ++col;
+      });
+    } else {
+      ParseOperations::ForEachColumn(row, [&](std::string_view cell) {
+        if (col < m_projection_mask.size() && m_projection_mask[col])
+          table.AppendCell(cell);
+        ++col;
+      });
+    }
+    return col;
+  }
+  // 按表中实际保存的列名解析schema
+  std::vector<ColumnType> ResolveColumnTypes() const {
+    const auto &names = m_table_names;
+    std::vector<ColumnType> types(names.size(), ColumnType::String);
+    for (const auto &spec : m_schema) {
+      auto it = std::find(names.begin(), names.end(), spec.name);
+      if (it == names.end())
+        throw ExceptionManager::InvalidHeaderLine("Unknown column in schema: " + spec.name);
+      types[it - names.begin()] = spec.type;
+    }
+    return types;
   }
   void Initialize() {
     m_header_line = "";
-    m_read_buffer = "";
+    m_read_buffer.reset();
+    m_buffer = {};
+    m_mapping.reset();
     m_column_names.clear();
-    m_csv_data.clear();
+    m_header_names.clear();
+    m_table_names.clear();
+    m_schema.clear();
+    m_projection.clear();
+    m_projection_mask.clear();
+    m_csv_data.Clear();
     m_rows.clear();
+    m_lazy.store(false, std::memory_order_relaxed);
+    m_lazy_rows.Reset(0);
+    m_persisted_rows = 0;
   }
 
   std::string m_header_line;
-  std::string m_read_buffer;
+  std::shared_ptr<std::string> m_read_buffer;
+  std::shared_ptr<const MemoryMap> m_mapping; // MemoryMapped模式下的文件映射
+  std::string_view m_buffer;                  // 指向m_read_buffer或映射区
   std::vector<std::string_view> m_column_names;
+  std::vector<std::string_view> m_header_names; // 文件首行的列名
+  std::vector<std::string_view> m_table_names;  // 表中实际保存的列名
+  std::vector<std::string> m_projection;        // 需要保存的列，为空表示全部
+  std::vector<char> m_projection_mask;          // 按源列序标记是否保存
+  ColumnSchema m_schema;                        // 需要类型化的列
   std::vector<std::string_view> m_rows;
-  std::vector<std::vector<std::string_view>> m_csv_data;
+  CSVTable m_csv_data;
+  size_t m_persisted_rows = 0; // 已与文件内容一致的行数，追加写出从这里开始
+  std::atomic<bool> m_lazy{false}; // 为true时m_csv_data为空，行按需切分到m_lazy_rows
+  mutable std::mutex m_lazy_mutex;  // 串行化行的首次切分与整表切分
+  LazyRowCache m_lazy_rows;         // 写入受m_lazy_mutex保护，已切分的行可无锁读取
+  CSVTable m_split_scratch;         // 懒切分时单行的临时缓冲，受m_lazy_mutex保护
+  ParseProfile m_profile;
+};
+
+// 流式读取：按固定块大小经BaseIO::Read读入，跨块的半行搬到下一块开头，内存占用与文件大小无关
+class CSVStreamReader {
+public:
+  // batch中的单元格指向内部缓冲区，仅在回调期间有效
+  using BatchCallback = std::function<void(const CSVTable &batch)>;
+  static constexpr size_t kDefaultChunkSize = 1 << 20;
+
+  explicit CSVStreamReader(size_t chunk_size = kDefaultChunkSize) : m_chunk_size(std::max<size_t>(chunk_size, 64)) {}
+  void SetColumnSchema(ColumnSchema schema) { m_schema = std::move(schema); }
+  const std::vector<std::string> &GetHeaderNames() const { return m_header_names; }
+
+  /**
+   * @brief 逐块读取并解析，每块完整的行作为一批交给onBatch
+   * @return 读取的数据行总数
+   */
+  size_t ReadBatches(const std::unique_ptr<BaseIO> &io, const BatchCallback &onBatch) {
+    std::vector<char> buffer(m_chunk_size);
+    size_t carry = 0; // 上一块遗留的不完整行
+    bool header_done = false;
+    size_t rows_read = 0;
+    m_header_names.clear();
+    CSVTable batch;
+
+    while (true) {
+      if (carry == buffer.size())
+        buffer.resize(buffer.size() * 2); // 单行超过块大小时扩容
+      size_t n = io->Read(buffer.data() + carry, buffer.size() - carry);
+      const bool eof = n == 0;
+      std::string_view data(buffer.data(), carry + n);
+      if (eof && data.empty())
+        break;
+      size_t complete = eof ? data.size() : data.rfind('\n') + 1; // npos + 1 == 0
+      if (complete == 0) {
+        carry = data.size();
+        continue;
+      }
+      std::string_view lines = data.substr(0, complete);
+      if (!header_done) {
+        auto pos = lines.find('\n');
+        ParseHeader(lines.substr(0, pos));
+        BindSchema(batch);
+        header_done = true;
+        lines = pos == std::string_view::npos ? std::string_view() : lines.substr(pos + 1);
+      }
+      Scanner::ForEachField(lines, '\n', [&](std::string_view row) {
+        ParseOperations::ForEachColumn(row, [&batch](std::string_view cell) { batch.AppendCell(cell); });
+        if (batch.PendingCellCount() != m_header_names.size())
+          throw ExceptionManager::InvalidDataLine(rows_read + batch.size() + 2, "Invalid columns");
+        batch.FinishRow();
+      });
+      if (!batch.empty()) {
+        rows_read += batch.size();
+        onBatch(batch);
+        batch.Clear();
+      }
+      if (eof)
+        break;
+      carry = data.size() - complete;
+      std::memmove(buffer.data(), buffer.data() + complete, carry);
+    }
+    return rows_read;
+  }
+
+private:
+  void ParseHeader(std::string_view header) {
+    if (!header.empty() && header.back() == '\r')
+      header.remove_suffix(1);
+    ParseOperations::ForEachColumn(header, [this](std::string_view name) { m_header_names.emplace_back(name); });
+  }
+  void BindSchema(CSVTable &batch) const {
+    if (m_schema.empty())
+      return;
+    std::vector<ColumnType> types(m_header_names.size(), ColumnType::String);
+    for (const auto &spec : m_schema) {
+      auto it = std::find(m_header_names.begin(), m_header_names.end(), spec.name);
+      if (it == m_header_names.end())
+        throw ExceptionManager::InvalidHeaderLine("Unknown column in schema: " + spec.name);
+      types[it - m_header_names.begin()] = spec.type;
+    }
+    batch.BindColumnTypes(std::move(types));
+  }
+
+  size_t m_chunk_size;
+  ColumnSchema m_schema;
+  std::vector<std::string> m_header_names;
 };
 
 class ParserStrategy {
@@ -270,8 +820,27 @@ public:
   void SetColumnNames(const std::vector<std::string_view> &columns) {
     m_impl->SetColumnNames(columns);
   }
-  std::vector<std::vector<std::string_view>> GetCSVData() const { return m_impl->GetCSVData(); }
+  void SetColumnSchema(ColumnSchema schema) { m_impl->SetColumnSchema(std::move(schema)); }
+  void SetProjection(std::vector<std::string> columns) { m_impl->SetProjection(std::move(columns)); }
+  bool LoadSnapshot(const std::string &source, const std::string &cache_dir, bool map_source) {
+    return m_impl->LoadSnapshot(source, cache_dir, map_source);
+  }
+  bool WriteSnapshot(const std::string &source, const std::string &cache_dir) {
+    return m_impl->WriteSnapshot(source, cache_dir);
+  }
+  void ResetProfile() { m_impl->ResetProfile(); }
+  const ParseProfile &GetProfile() const { return m_impl->GetProfile(); }
+  bool LoadImage(std::shared_ptr<const MemoryMap> mapping, std::string_view content, std::string_view image) {
+    return m_impl->LoadImage(std::move(mapping), content, image);
+  }
+  bool ExportImage(std::string &content, std::string &image) const { return m_impl->ExportImage(content, image); }
+  void AppendDataToCSV(const std::string &destination_path) { m_impl->AppendToFile(destination_path); }
+  const CSVTable &GetCSVData() const { return m_impl->GetCSVData(); }
   size_t GetCSVDataSize() const noexcept { return m_impl->GetDataSize(); }
+  CSVTable::RowView GetRow(size_t row) const { return m_impl->GetRow(row); }
+  std::shared_ptr<const void> GetSourceBuffer() const { return m_impl->GetSourceBuffer(); }
+  CSVTable TakeCSVData() { return m_impl->TakeCSVData(); }
+  LazyTableStats GetLazyStats() const { return m_impl->GetLazyStats(); }
 
   void OnOperation(OperateStrategyCallback doOperation) {
     m_impl->OnOperationCallback(doOperation);
@@ -282,6 +851,7 @@ public:
   }
 
   const std::vector<std::string_view> &GetColumnNames() const { return m_impl->GetColumnNames(); }
+  const std::vector<std::string_view> &GetTableColumnNames() const { return m_impl->GetTableColumnNames(); }
 
 protected:
   std::unique_ptr<ParserImpl> m_impl = nullptr;
@@ -292,6 +862,7 @@ public:
   virtual void ParseDataFromCSV(const std::unique_ptr<BaseIO> &io, const size_t &size) override {
     m_impl->ParseRows(std::move(io), size);
     m_impl->ParseColumns(m_impl->GetRowData());
+    m_impl->FinishParse();
   }
 
   virtual void WriteDataToCSV(const std::string &destination_path) override {
@@ -301,12 +872,22 @@ public:
 
 class AsynchronousParser : public ParserStrategy {
 public:
-  AsynchronousParser(size_t thread_num = std::thread::hardware_concurrency())
-      : m_thread_num(thread_num) {}
+  static constexpr size_t kInlineThreshold = 1 << 20; // 小于该字节数的文件直接同步解析
+
+  AsynchronousParser(std::shared_ptr<ThreadPool> pool = ThreadPool::Shared(),
+                     size_t inline_threshold = kInlineThreshold)
+      : m_pool(std::move(pool)), m_inline_threshold(inline_threshold) {}
 
   virtual void ParseDataFromCSV(const std::unique_ptr<BaseIO> &io, const size_t &size) override {
-    m_impl->ParseRows(std::move(io), size);
-    m_impl->AsyncParseColumns(m_impl->GetRowData(), m_thread_num);
+    if (size < m_inline_threshold || !m_pool) {
+      // 小文件的调度开销大于解析本身，直接在调用线程解析
+      m_impl->ParseRows(io, size);
+      m_impl->ParseColumns(m_impl->GetRowData());
+    } else {
+      m_impl->LoadBuffer(io, size);
+      m_impl->AsyncParseRanges(*m_pool);
+    }
+    m_impl->FinishParse();
   }
 
   virtual void WriteDataToCSV(const std::string &destination_path) override {
@@ -314,14 +895,29 @@ public:
   }
 
 private:
-  size_t m_thread_num = 0;
+  std::shared_ptr<ThreadPool> m_pool;
+  size_t m_inline_threshold = 0;
+};
+
+// 懒切分：加载时只建行索引（映射文件、不拷贝），行在首次访问时切分
+class LazyParser : public ParserStrategy {
+public:
+  virtual void ParseDataFromCSV(const std::unique_ptr<BaseIO> &io, const size_t &size) override {
+    m_impl->ParseRows(io, size);
+    m_impl->FinishParse();
+    m_impl->BuildLazyIndex();
+  }
+
+  virtual void WriteDataToCSV(const std::string &destination_path) override {
+    m_impl->WriteToFile(destination_path);
+  }
 };
 
-enum class ParseMode { Synchronous, Asynchronous };
+enum class ParseMode { Synchronous, Asynchronous, MemoryMapped, Lazy };
 
 class CSVParser {
 public:
-  using DataContainer = std::vector<std::vector<std::string_view>>;
+  using DataContainer = CSVTable;
   CSVParser() = default;
   CSVParser(const CSVParser &) = delete;
   CSVParser &operator=(const CSVParser &) = delete;
@@ -345,25 +941,97 @@ public:
     m_parser->SetColumnNames(column_names);
   }
   void SetParser(ParseMode mode) {
+    m_mode = mode;
     switch (mode) {
     case ParseMode::Synchronous:
+    case ParseMode::MemoryMapped:
       m_parser = std::make_unique<SynchronousParser>();
       break;
     case ParseMode::Asynchronous:
       m_parser = std::make_unique<AsynchronousParser>();
       break;
+    case ParseMode::Lazy:
+      m_parser = std::make_unique<LazyParser>();
+      break;
     default:
       throw std::runtime_error("Unsupported parse mode.");
     }
   }
+  /**
+   * @brief 声明需要类型化的列，例如 {{"Freq", ColumnType::Double}, {"PortNo", ColumnType::UInt32}}
+   * 这些列在加载时用from_chars一次性转换为连续数组，其余列仍以string_view访问
+   */
+  void SetColumnSchema(ColumnSchema schema) { m_parser->SetColumnSchema(std::move(schema)); }
+  /**
+   * @brief 只保存指定列，例如 {"Freq", "Power", "Data"}；其余列仍参与列数校验但不存储
+   * 投影列按源文件中的列序排列，可通过GetTableColumnNames查看；投影解析不读写.csvbin快照
+   */
+  void SetProjection(std::vector<std::string> columns) { m_parser->SetProjection(std::move(columns)); }
+  /**
+   * @brief 启用.csvbin快照（默认关闭）：解析结果保存到cache_dir，源文件未变化时下次直接加载快照
+   * 加载快照时源内容的持有方式与解析模式一致：映射模式指向文件映射，其余模式读入自有缓冲区
+   * @param cache_dir 快照目录，不存在时自动创建；为空时写在源文件旁，只适用于可写且不共享的配置目录
+   */
+  void EnableBinaryCache(std::string cache_dir = {}) {
+    m_binary_cache = true;
+    m_cache_dir = std::move(cache_dir);
+  }
+  void DisableBinaryCache() {
+    m_binary_cache = false;
+    m_cache_dir.clear();
+  }
   void ParseDataFromCSV(const std::string &filename) {
+    m_parser->ResetProfile();
+    if (m_binary_cache && m_parser->LoadSnapshot(filename, m_cache_dir, MapsSource()))
+      return;
     auto fileManager = std::make_unique<FileManager>(filename);
-    auto fileHandler = fileManager->CreateFileHandler();
+    auto fileHandler = MapsSource() ? fileManager->CreateMappedFileHandler() : fileManager->CreateFileHandler();
     m_parser->ParseDataFromCSV(fileHandler, fileManager->GetFileSize());
+    if (m_binary_cache)
+      m_parser->WriteSnapshot(filename, m_cache_dir);
+  }
+  /**
+   * @brief 从快照映像加载（如配置包中的表），不访问文件系统
+   * @param mapping 映像与content所在的映射，随解析结果一起保活
+   * @return 映像损坏或与当前列配置不符时返回false
+   */
+  bool LoadImage(std::shared_ptr<const MemoryMap> mapping, std::string_view content, std::string_view image) {
+    m_parser->ResetProfile();
+    return m_parser->LoadImage(std::move(mapping), content, image);
   }
-  DataContainer GetCSVData() const { return m_parser->GetCSVData(); }
+  // 最近一次ParseDataFromCSV或LoadImage的分阶段耗时、行列数与估算的内存峰值
+  const ParseProfile &GetParseProfile() const { return m_parser->GetProfile(); }
+  // 导出源内容与快照映像（.csvbin格式，不含时间戳）；投影或Lazy模式下返回false
+  bool ExportImage(std::string &content, std::string &image) const { return m_parser->ExportImage(content, image); }
+  /**
+   * @brief 流式扫描大文件，不驻留整表；batch仅在回调期间有效
+   * @return 读取的数据行总数
+   */
+  static size_t StreamDataFromCSV(const std::string &filename, const CSVStreamReader::BatchCallback &onBatch,
+                                  size_t chunk_size = CSVStreamReader::kDefaultChunkSize,
+                                  ColumnSchema schema = {}) {
+    auto fileManager = std::make_unique<FileManager>(filename);
+    auto fileHandler = fileManager->CreateFileHandler();
+    CSVStreamReader reader(chunk_size);
+    reader.SetColumnSchema(std::move(schema));
+    return reader.ReadBatches(fileHandler, onBatch);
+  }
+  // Lazy模式下首次调用会切分全部剩余行
+  const DataContainer &GetCSVData() const { return m_parser->GetCSVData(); }
   size_t GetCSVDataSize() const noexcept { return m_parser->GetCSVDataSize(); }
+  // 按行号取一行，可多线程并发调用；Lazy模式下首次访问时切分并缓存，列数不符时抛InvalidDataLine
+  CSVTable::RowView GetRow(size_t row) const { return m_parser->GetRow(row); }
+  // 已切分与待切分部分各自的内存占用
+  LazyTableStats GetLazyStats() const { return m_parser->GetLazyStats(); }
+  /**
+   * @brief 移出解析结果（交给VersionedTable等外部存储），解析器中的表随之清空
+   * 表中单元格指向GetSourceBuffer返回的缓冲区，须一并持有
+   */
+  CSVTable TakeCSVData() { return m_parser->TakeCSVData(); }
+  std::shared_ptr<const void> GetSourceBuffer() const { return m_parser->GetSourceBuffer(); }
   void WriteCSVDataToFile(const std::string &filename) { m_parser->WriteDataToCSV(filename); }
+  // 只追加解析或上次写出之后新增的行
+  void AppendCSVDataToFile(const std::string &filename) { m_parser->AppendDataToCSV(filename); }
   void OnAdd(OperateStrategyCallback Add) { m_parser->OnOperation(Add); }
   void OnDelete(OperateStrategyCallback Del) { m_parser->OnOperation(Del); }
   void OnModify(OperateStrategyCallback Modify) { m_parser->OnOperation(Modify); }
@@ -371,8 +1039,16 @@ public:
     return m_parser->OnQuery(Query);
   }
   const std::vector<std::string_view> &GetColumnNames() const { return m_parser->GetColumnNames(); }
+  // 表中实际保存的列名，列序号与GetCSVData中的一致
+  const std::vector<std::string_view> &GetTableColumnNames() const { return m_parser->GetTableColumnNames(); }
 
 private:
+  // 映射模式下单元格直接指向源文件的映射，源文件须整体替换（写新文件后rename），不能原地改写
+  bool MapsSource() const { return m_mode == ParseMode::MemoryMapped || m_mode == ParseMode::Lazy; }
+
+  ParseMode m_mode = ParseMode::Synchronous;
+  bool m_binary_cache = false;
+  std::string m_cache_dir; // 为空时快照放在源文件旁
   std::unique_ptr<ParserStrategy> m_parser = nullptr;
 };
 
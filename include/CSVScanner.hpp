@@ -0,0 +1,153 @@
+#ifndef CSV_CSVSCANNER_HPP
+#define CSV_CSVSCANNER_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CSV_SCANNER_X86 1
+#endif
+
+namespace CSVUtils {
+
+// 分隔符扫描：每次处理64字节，生成“分隔符或'\r'”的位图，再逐位取出候选位置
+namespace Scanner {
+
+using BlockMask = uint64_t;
+using MaskBuilder = BlockMask (*)(const char *block, char ch);
+constexpr size_t kBlockSize = 64;
+
+inline BlockMask ScalarMask(const char *block, char ch) {
+  BlockMask mask = 0;
+  for (size_t i = 0; i < kBlockSize; ++i) {
+    if (block[i] == ch || block[i] == '\r')
+      mask |= BlockMask{1} << i;
+  }
+  return mask;
+}
+
+#ifdef CSV_SCANNER_X86
+// 只用到SSE2指令（x86_64的基线），每次比较16字节
+__attribute__((target("sse2"))) inline BlockMask Sse2Mask(const char *block, char ch) {
+  const __m128i delimiter = _mm_set1_epi8(ch);
+  const __m128i carriage = _mm_set1_epi8('\r');
+  BlockMask mask = 0;
+  for (size_t i = 0; i < kBlockSize; i += 16) {
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + i));
+    __m128i hit = _mm_or_si128(_mm_cmpeq_epi8(chunk, delimiter), _mm_cmpeq_epi8(chunk, carriage));
+    mask |= static_cast<BlockMask>(static_cast<uint16_t>(_mm_movemask_epi8(hit))) << i;
+  }
+  return mask;
+}
+
+// 不参与运行时选择：逐块经函数指针调用时相对Sse2Mask的收益不稳定，部分机器上反而更慢，仅供ScannerBenchmark对比
+__attribute__((target("avx2"))) inline BlockMask Avx2Mask(const char *block, char ch) {
+  const __m256i delimiter = _mm256_set1_epi8(ch);
+  const __m256i carriage = _mm256_set1_epi8('\r');
+  __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block));
+  __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block + 32));
+  __m256i hit_lo = _mm256_or_si256(_mm256_cmpeq_epi8(lo, delimiter), _mm256_cmpeq_epi8(lo, carriage));
+  __m256i hit_hi = _mm256_or_si256(_mm256_cmpeq_epi8(hi, delimiter), _mm256_cmpeq_epi8(hi, carriage));
+  auto mask_lo = static_cast<uint32_t>(_mm256_movemask_epi8(hit_lo));
+  auto mask_hi = static_cast<uint32_t>(_mm256_movemask_epi8(hit_hi));
+  return (static_cast<BlockMask>(mask_hi) << 32) | mask_lo;
+}
+#endif
+
+// 运行时按CPU能力选择实现：x86上为SSE2（32位x86需检查），其余平台使用标量实现
+inline MaskBuilder SelectMaskBuilder() {
+#ifdef CSV_SCANNER_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("sse2"))
+    return Sse2Mask;
+#endif
+  return ScalarMask;
+}
+
+inline MaskBuilder GetMaskBuilder() {
+  static const MaskBuilder builder = SelectMaskBuilder();
+  return builder;
+}
+
+inline unsigned LowestBit(BlockMask mask) { return static_cast<unsigned>(__builtin_ctzll(mask)); }
+
+/**
+ * @brief 按分隔符ch或"\r\n"切分str，对每个非空字段调用fn(field)
+ * @param builder 位图生成函数，默认按CPU能力选择
+ */
+template <typename Fn>
+void ForEachField(std::string_view str, char ch, Fn &&fn, MaskBuilder builder = GetMaskBuilder()) {
+  const size_t size = str.size();
+  size_t start = 0;
+  size_t skip_until = 0; // "\r\n"中的'\n'已被消费
+  auto emit = [&](size_t end) {
+    if (end > start)
+      fn(str.substr(start, end - start));
+  };
+  auto on_candidate = [&](size_t pos) {
+    if (pos < skip_until)
+      return;
+    if (str[pos] == ch) {
+      emit(pos);
+      start = pos + 1;
+    } else if (pos + 1 < size && str[pos + 1] == '\n') {
+      emit(pos);
+      start = pos + 2;
+      skip_until = pos + 2;
+    }
+  };
+
+  size_t base = 0;
+  for (; base + kBlockSize <= size; base += kBlockSize) {
+    BlockMask mask = builder(str.data() + base, ch);
+    while (mask) {
+      on_candidate(base + LowestBit(mask));
+      mask &= mask - 1;
+    }
+  }
+  if (base < size) {
+    // 尾部不足一个块时拷入零填充缓冲区，同样走位图路径
+    char tail[kBlockSize] = {};
+    std::copy(str.begin() + base, str.end(), tail);
+    BlockMask mask = builder(tail, ch);
+    while (mask) {
+      on_candidate(base + LowestBit(mask));
+      mask &= mask - 1;
+    }
+  }
+  emit(size);
+}
+
+/**
+ * @brief 估算str中的候选分隔符数量，用于切分前预留容量
+ * 只扫描开头kEstimateSampleBytes字节并按长度外推，避免为预留容量把整段数据多扫一遍；
+ * 样本之后字段变长或变短时只会多一次扩容或多留一些容量
+ */
+constexpr size_t kEstimateSampleBytes = 16 * kBlockSize;
+
+inline size_t EstimateCandidates(std::string_view str, char ch, MaskBuilder builder = GetMaskBuilder()) {
+  const size_t sample = std::min(str.size(), kEstimateSampleBytes);
+  size_t count = 0;
+  size_t base = 0;
+  for (; base + kBlockSize <= sample; base += kBlockSize)
+    count += static_cast<size_t>(__builtin_popcountll(builder(str.data() + base, ch)));
+  if (base < sample) {
+    char tail[kBlockSize] = {};
+    std::copy(str.begin() + base, str.begin() + sample, tail);
+    count += static_cast<size_t>(__builtin_popcountll(builder(tail, ch)));
+  }
+  if (sample == str.size())
+    return count;
+  // 按样本密度外推，多留1/8余量，使样本略偏稀时也不必扩容
+  const double density = static_cast<double>(count) / static_cast<double>(sample);
+  return static_cast<size_t>(density * static_cast<double>(str.size()) * 1.125);
+}
+
+} // namespace Scanner
+
+} // namespace CSVUtils
+
+#endif // CSV_CSVSCANNER_HPP
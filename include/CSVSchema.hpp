@@ -0,0 +1,281 @@
+#ifndef CSV_CSVSCHEMA_HPP
+#define CSV_CSVSCHEMA_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "CSVReader.h"
+
+// 可作为模板参数的字符串字面量，如 Column<"Freq", double>
+template <size_t N> struct FixedString {
+  char value[N]{};
+  constexpr FixedString(const char (&str)[N]) { std::copy_n(str, N, value); }
+  constexpr std::string_view view() const { return {value, N - 1}; }
+};
+
+// 字典编码列的类型标记：Column<"Module", DictionaryEncoded>按DictionaryColumn存储
+struct DictionaryEncoded {};
+
+// 编译期列声明：列名 + C++类型（算术类型、std::string_view或DictionaryEncoded）
+template <FixedString Name, typename T> struct Column {
+  static constexpr std::string_view name = Name.view();
+  using type = T;
+  static_assert(std::is_arithmetic_v<T> || std::is_same_v<T, std::string_view> ||
+                    std::is_same_v<T, DictionaryEncoded>,
+                "Column type must be arithmetic, std::string_view or DictionaryEncoded");
+};
+
+/**
+ * @brief 编译期schema：列名与类型组成的类型列表，列序号在编译期求出
+ * 例如 using Schema = CSVSchema<Column<"Freq", double>, Column<"Power", double>>;
+ */
+template <typename... Columns> struct CSVSchema {
+  static constexpr size_t size = sizeof...(Columns);
+  static constexpr std::array<std::string_view, size> names{Columns::name...};
+  template <size_t I> using TypeAt = typename std::tuple_element_t<I, std::tuple<Columns...>>::type;
+
+  static constexpr size_t Find(std::string_view name) {
+    for (size_t i = 0; i < size; ++i) {
+      if (names[i] == name)
+        return i;
+    }
+    return size;
+  }
+  template <FixedString Name> static constexpr size_t IndexOf() {
+    constexpr size_t index = Find(Name.view());
+    static_assert(index < size, "Column is not declared in schema");
+    return index;
+  }
+  template <FixedString Name> using TypeOf = TypeAt<IndexOf<Name>()>;
+
+  // 转为运行时schema供CSVParser使用；double/uint32_t/DictionaryEncoded之外的列按String处理
+  static ColumnSchema ToColumnSchema() {
+    return {ColumnSpec{std::string(Columns::name), RuntimeType<typename Columns::type>()}...};
+  }
+
+private:
+  template <typename T> static constexpr ColumnType RuntimeType() {
+    if constexpr (std::is_same_v<T, double>)
+      return ColumnType::Double;
+    else if constexpr (std::is_same_v<T, uint32_t>)
+      return ColumnType::UInt32;
+    else if constexpr (std::is_same_v<T, DictionaryEncoded>)
+      return ColumnType::Dictionary;
+    else
+      return ColumnType::String;
+  }
+};
+
+// 按schema生成的列存储(SoA)表：每列一个连续数组，col<"Freq">()在编译期定位
+template <typename Schema> class TypedCSVTable {
+public:
+  // 列的存储类型：DictionaryEncoded列为DictionaryColumn，其余为std::vector<T>
+  template <typename T>
+  using Storage = std::conditional_t<std::is_same_v<T, DictionaryEncoded>, DictionaryColumn, std::vector<T>>;
+
+  size_t size() const noexcept { return m_size; }
+  bool empty() const noexcept { return m_size == 0; }
+
+  // 数值/string_view列返回连续span，字典列返回DictionaryColumn
+  template <FixedString Name> decltype(auto) col() const {
+    using T = typename Schema::template TypeOf<Name>;
+    const auto &column = std::get<Schema::template IndexOf<Name>()>(m_columns);
+    if constexpr (std::is_same_v<T, DictionaryEncoded>)
+      return (column);
+    else
+      return std::span<const T>(column);
+  }
+  template <FixedString Name> auto at(size_t row) const {
+    return std::get<Schema::template IndexOf<Name>()>(m_columns)[row];
+  }
+
+  void Reserve(size_t rows) {
+    std::apply([rows](auto &...columns) { (ReserveColumn(columns, rows), ...); }, m_columns);
+  }
+  void Clear() {
+    std::apply([](auto &...columns) { (ClearColumn(columns), ...); }, m_columns);
+    m_size = 0;
+  }
+  template <size_t I> auto &Column() { return std::get<I>(m_columns); }
+  void FinishRow() { ++m_size; }
+
+private:
+  template <typename T> static void ReserveColumn(std::vector<T> &column, size_t rows) { column.reserve(rows); }
+  static void ReserveColumn(DictionaryColumn &column, size_t rows) { column.Reserve(rows); }
+  template <typename T> static void ClearColumn(std::vector<T> &column) { column.clear(); }
+  static void ClearColumn(DictionaryColumn &column) { column.Clear(); }
+
+  template <typename> struct Columns;
+  template <size_t... I> struct Columns<std::index_sequence<I...>> {
+    using type = std::tuple<Storage<typename Schema::template TypeAt<I>>...>;
+  };
+
+  typename Columns<std::make_index_sequence<Schema::size>>::type m_columns;
+  size_t m_size = 0;
+};
+
+/**
+ * @brief 编译期schema的解析器：只保存schema中的列，每列的转换函数在编译期按类型特化
+ * 文件中未在schema里声明的列只参与列数校验；string_view列指向解析器持有的文件映射
+ */
+template <typename Schema> class TypedCSVParser {
+public:
+  using DataContainer = TypedCSVTable<Schema>;
+
+  // SetColumnNames中表示“该文件列不保存”的占位名
+  static constexpr FixedString kSkip = "";
+
+  /**
+   * @brief 指定文件的列布局（按文件列序），如 SetColumnNames<"Freq", kSkip, "Power">()
+   * 列名在编译期校验：必须属于schema，不能重复，且schema中的每一列都必须出现；不保存的文件列用kSkip占位
+   * 未调用时按文件表头匹配schema中的列
+   */
+  template <FixedString... Names> void SetColumnNames() {
+    static_assert(sizeof...(Names) > 0, "No column names provided");
+    constexpr std::array<size_t, sizeof...(Names)> indices{LayoutIndex<Names>()...};
+    static_assert(!HasDuplicates(indices), "Duplicate column names found");
+    static_assert(IsCompleteLayout<Names...>(), "Every schema column must appear in the layout");
+    m_layout.assign(indices.begin(), indices.end());
+  }
+  // 布局是否覆盖schema中的全部列（kSkip不计）
+  template <FixedString... Names> static constexpr bool IsCompleteLayout() {
+    constexpr std::array<size_t, sizeof...(Names)> indices{LayoutIndex<Names>()...};
+    return !HasDuplicates(indices) &&
+           static_cast<size_t>(std::count_if(indices.begin(), indices.end(),
+                                             [](size_t index) { return index < Schema::size; })) == Schema::size;
+  }
+
+  /**
+   * @brief 映射并解析整个文件，解析失败时抛出与CSVParser相同的异常
+   * 失败时表被清空，不会留下指向已释放映射的单元格或长短不一的列
+   */
+  void ParseDataFromCSV(const std::string &filename) {
+    FileManager fileManager(filename);
+    auto mapping = fileManager.CreateMappedFileHandler()->GetMapping();
+    mapping->AdviseSequential();
+    // 先接管映射再解析，解析过程中写入的string_view列始终指向存活的映射
+    m_table.Clear();
+    m_mapping = mapping;
+    try {
+      ParseBuffer(mapping->View());
+    } catch (...) {
+      m_table.Clear();
+      m_mapping.reset();
+      throw;
+    }
+    mapping->AdviseNormal();
+  }
+
+  const DataContainer &GetCSVData() const { return m_table; }
+  size_t GetCSVDataSize() const noexcept { return m_table.size(); }
+
+private:
+  using ColumnSink = bool (*)(DataContainer &, std::string_view);
+
+  void ParseBuffer(std::string_view buffer) {
+    auto pos = buffer.find('\n');
+    std::string_view header = buffer.substr(0, pos);
+    std::string_view body = pos == std::string_view::npos ? std::string_view() : buffer.substr(pos + 1);
+    const auto layout = ResolveLayout(header);
+
+    std::vector<ColumnSink> sinks(layout.size(), nullptr);
+    for (size_t col = 0; col < layout.size(); ++col) {
+      if (layout[col] < Schema::size)
+        sinks[col] = SinkTable()[layout[col]];
+    }
+    m_table.Reserve(Scanner::EstimateCandidates(body, '\n'));
+    size_t line = 1; // 首行为表头
+    Scanner::ForEachField(body, '\n', [&](std::string_view row) {
+      ++line;
+      size_t col = 0;
+      Scanner::ForEachField(row, ',', [&](std::string_view cell) {
+        if (col < sinks.size() && sinks[col] && !sinks[col](m_table, cell))
+          throw ExceptionManager::InvalidDataLine(line, "Invalid numeric cell in column " + std::to_string(col));
+        ++col;
+      });
+      if (col != layout.size())
+        throw ExceptionManager::InvalidDataLine(line, "Invalid columns");
+      m_table.FinishRow();
+    });
+  }
+
+  template <size_t I> static bool AppendCell(DataContainer &table, std::string_view cell) {
+    using T = typename Schema::template TypeAt<I>;
+    if constexpr (std::is_same_v<T, std::string_view>) {
+      table.template Column<I>().push_back(cell);
+      return true;
+    } else if constexpr (std::is_same_v<T, DictionaryEncoded>) {
+      table.template Column<I>().Append(cell);
+      return true;
+    } else {
+      T value{};
+      bool ok = CSVUtils::ParseNumber(cell, value);
+      table.template Column<I>().push_back(value);
+      return ok;
+    }
+  }
+  template <size_t... I> static constexpr std::array<ColumnSink, Schema::size> MakeSinks(std::index_sequence<I...>) {
+    return {&AppendCell<I>...};
+  }
+  static const std::array<ColumnSink, Schema::size> &SinkTable() {
+    static constexpr auto sinks = MakeSinks(std::make_index_sequence<Schema::size>{});
+    return sinks;
+  }
+
+  // 文件列 -> schema列序号，Schema::size表示该文件列不保存
+  std::vector<size_t> ResolveLayout(std::string_view header) const {
+    if (!m_layout.empty())
+      return m_layout;
+    if (!header.empty() && header.back() == '\r')
+      header.remove_suffix(1);
+    std::vector<size_t> layout;
+    std::vector<bool> found(Schema::size, false);
+    Scanner::ForEachField(header, ',', [&](std::string_view name) {
+      size_t index = Schema::Find(name);
+      if (index < Schema::size) {
+        // 同一列出现两次会让该列比其他列多出一倍的元素
+        if (found[index])
+          throw ExceptionManager::InvalidHeaderLine("Duplicate column in header: " + std::string(name));
+        found[index] = true;
+      }
+      layout.push_back(index);
+    });
+    for (size_t i = 0; i < Schema::size; ++i) {
+      if (!found[i])
+        throw ExceptionManager::InvalidHeaderLine("Unknown column in schema: " + std::string(Schema::names[i]));
+    }
+    return layout;
+  }
+
+  template <FixedString Name> static constexpr size_t LayoutIndex() {
+    if constexpr (Name.view().empty())
+      return Schema::size;
+    else
+      return Schema::template IndexOf<Name>();
+  }
+  // kSkip可以出现多次，不算重复
+  template <size_t N> static constexpr bool HasDuplicates(std::array<size_t, N> list) {
+    std::sort(list.begin(), list.end());
+    for (size_t i = 1; i < N; ++i) {
+      if (list[i] == list[i - 1] && list[i] < Schema::size)
+        return true;
+    }
+    return false;
+  }
+
+  std::vector<size_t> m_layout;
+  std::shared_ptr<const MemoryMap> m_mapping; // string_view列指向这里
+  DataContainer m_table;
+};
+
+#endif // CSV_CSVSCHEMA_HPP
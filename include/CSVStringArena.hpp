@@ -0,0 +1,72 @@
+#ifndef CSV_CSVSTRINGARENA_HPP
+#define CSV_CSVSTRINGARENA_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+// 只追加的字符串存储：按块分配，已存入的字符串永不移动，返回的视图在arena存活期间一直有效
+class StringArena {
+public:
+  static constexpr size_t kDefaultChunkSize = 64 * 1024;
+
+  // 回滚点，用于撤销一次失败的批量写入
+  struct Mark {
+    size_t chunks = 0;
+    size_t used = 0;
+    size_t stored = 0;
+  };
+
+  explicit StringArena(size_t chunk_size = kDefaultChunkSize) : m_chunk_size(std::max<size_t>(chunk_size, 256)) {}
+  StringArena(const StringArena &) = delete;
+  StringArena &operator=(const StringArena &) = delete;
+
+  // 拷贝text到arena，超过块大小的字符串单独占一块
+  std::string_view Store(std::string_view text) {
+    if (text.empty())
+      return {};
+    if (m_chunks.empty() || m_chunks.back().capacity - m_used < text.size()) {
+      const size_t capacity = std::max(m_chunk_size, text.size());
+      m_chunks.push_back(Chunk{std::make_unique<char[]>(capacity), capacity});
+      m_used = 0;
+      m_reserved_bytes += capacity;
+    }
+    char *dest = m_chunks.back().data.get() + m_used;
+    std::memcpy(dest, text.data(), text.size());
+    m_used += text.size();
+    m_stored_bytes += text.size();
+    return {dest, text.size()};
+  }
+
+  Mark GetMark() const { return {m_chunks.size(), m_used, m_stored_bytes}; }
+  // 撤销mark之后存入的字符串；调用方须保证这些视图未被发布
+  void Rollback(const Mark &mark) {
+    while (m_chunks.size() > mark.chunks) {
+      m_reserved_bytes -= m_chunks.back().capacity;
+      m_chunks.pop_back();
+    }
+    m_used = mark.used;
+    m_stored_bytes = mark.stored;
+  }
+
+  size_t ChunkCount() const noexcept { return m_chunks.size(); }
+  size_t StoredBytes() const noexcept { return m_stored_bytes; }     // 字符串本身占用
+  size_t ReservedBytes() const noexcept { return m_reserved_bytes; } // 已分配的块总大小
+
+private:
+  struct Chunk {
+    std::unique_ptr<char[]> data;
+    size_t capacity = 0;
+  };
+
+  size_t m_chunk_size;
+  std::vector<Chunk> m_chunks;
+  size_t m_used = 0; // 最后一块已用字节
+  size_t m_stored_bytes = 0;
+  size_t m_reserved_bytes = 0;
+};
+
+#endif // CSV_CSVSTRINGARENA_HPP
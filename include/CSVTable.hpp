@@ -0,0 +1,479 @@
+#ifndef CSV_CSVTABLE_HPP
+#define CSV_CSVTABLE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "ExceptionManager.hpp"
+
+// 列类型：String列只保留视图，数值列在加载时一次性转换，Dictionary列编码为整数
+enum class ColumnType { String, Double, UInt32, Dictionary };
+
+struct ColumnSpec {
+  std::string name;
+  ColumnType type = ColumnType::String;
+};
+using ColumnSchema = std::vector<ColumnSpec>;
+
+namespace CSVUtils {
+// 去掉首尾空白与正号后用from_chars转换，失败返回false
+template <typename T> bool ParseNumber(std::string_view text, T &value) {
+  while (!text.empty() && (text.front() == ' ' || text.front() == '\t'))
+    text.remove_prefix(1);
+  while (!text.empty() && (text.back() == ' ' || text.back() == '\t' || text.back() == '\r'))
+    text.remove_suffix(1);
+  if (!text.empty() && text.front() == '+')
+    text.remove_prefix(1);
+  auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+  return ec == std::errc() && ptr == text.data() + text.size();
+}
+} // namespace CSVUtils
+
+// 字典编码列：每个不同取值只在字典中存一次，每行只存4字节编码，等值匹配变为整数比较
+class DictionaryColumn {
+public:
+  static constexpr uint32_t kNotFound = UINT32_MAX;
+
+  size_t size() const noexcept { return m_codes.size(); }
+  // 追加一行的取值，返回其编码
+  uint32_t Append(std::string_view value) {
+    auto [it, inserted] = m_index.try_emplace(value, static_cast<uint32_t>(m_values.size()));
+    if (inserted)
+      m_values.push_back(value);
+    m_codes.push_back(it->second);
+    return it->second;
+  }
+  // 查询取值对应的编码，字典中没有时返回kNotFound
+  uint32_t Find(std::string_view value) const {
+    auto it = m_index.find(value);
+    return it == m_index.end() ? kNotFound : it->second;
+  }
+  std::string_view Decode(uint32_t code) const { return m_values[code]; }
+  std::string_view operator[](size_t row) const { return m_values[m_codes[row]]; }
+  uint32_t CodeAt(size_t row) const { return m_codes[row]; }
+  std::span<const uint32_t> Codes() const noexcept { return m_codes; }
+  const std::vector<std::string_view> &Values() const noexcept { return m_values; }
+
+  void Reserve(size_t rows) { m_codes.reserve(rows); }
+  // 编码与字典占用的堆内存（估算，不含取值指向的源缓冲区）
+  size_t MemoryBytes() const noexcept {
+    return m_codes.capacity() * sizeof(uint32_t) + m_values.capacity() * sizeof(std::string_view) +
+           m_index.size() * (sizeof(std::string_view) + sizeof(uint32_t) + 2 * sizeof(void *));
+  }
+  // 只截断行编码，字典项保留，编码保持稳定
+  void Truncate(size_t rows) { m_codes.resize(std::min(m_codes.size(), rows)); }
+  void Clear() {
+    m_codes.clear();
+    m_values.clear();
+    m_index.clear();
+  }
+
+private:
+  std::vector<uint32_t> m_codes;
+  std::vector<std::string_view> m_values;
+  std::unordered_map<std::string_view, uint32_t> m_index;
+};
+
+/**
+ * @brief 扁平化(CSR)表格存储：所有单元格连续存放，行通过偏移量划分
+ * 也可由Concat把若干不可变的扁平表按序拼成只读的分段表，各段在多张表之间共享而不复制
+ */
+class CSVTable {
+public:
+  using Cell = std::string_view;
+  using RowView = std::span<const Cell>; // 行视图，构造无开销
+
+  class const_iterator {
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = RowView;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = RowView;
+
+    const_iterator() = default;
+    const_iterator(const CSVTable *table, size_t row) : m_table(table), m_row(row) {}
+    RowView operator*() const { return (*m_table)[m_row]; }
+    RowView operator[](difference_type n) const { return (*m_table)[m_row + n]; }
+    const_iterator &operator++() {
+      ++m_row;
+      return *this;
+    }
+    const_iterator operator++(int) { return {m_table, m_row++}; }
+    const_iterator &operator--() {
+      --m_row;
+      return *this;
+    }
+    const_iterator operator--(int) { return {m_table, m_row--}; }
+    const_iterator &operator+=(difference_type n) {
+      m_row += n;
+      return *this;
+    }
+    const_iterator &operator-=(difference_type n) {
+      m_row -= n;
+      return *this;
+    }
+    friend const_iterator operator+(const_iterator it, difference_type n) { return it += n; }
+    friend const_iterator operator-(const_iterator it, difference_type n) { return it -= n; }
+    friend difference_type operator-(const const_iterator &a, const const_iterator &b) {
+      return static_cast<difference_type>(a.m_row) - static_cast<difference_type>(b.m_row);
+    }
+    friend bool operator==(const const_iterator &a, const const_iterator &b) { return a.m_row == b.m_row; }
+    friend auto operator<=>(const const_iterator &a, const const_iterator &b) { return a.m_row <=> b.m_row; }
+
+  private:
+    const CSVTable *m_table = nullptr;
+    size_t m_row = 0;
+  };
+
+  CSVTable() = default;
+
+  size_t size() const noexcept { return m_segments.empty() ? m_row_offsets.size() - 1 : m_segment_ends.back(); }
+  bool empty() const noexcept { return size() == 0; }
+  size_t CellCount() const noexcept { return m_cells.size(); }
+  RowView operator[](size_t row) const {
+    if (!m_segments.empty()) {
+      auto [segment, local] = Locate(row);
+      return (*m_segments[segment])[local];
+    }
+    return RowView(m_cells.data() + m_row_offsets[row], m_row_offsets[row + 1] - m_row_offsets[row]);
+  }
+  RowView front() const { return (*this)[0]; }
+  RowView back() const { return (*this)[size() - 1]; }
+  const_iterator begin() const { return {this, 0}; }
+  const_iterator end() const { return {this, size()}; }
+
+  /**
+   * @brief 把segments按序拼成一张只读表，不复制单元格；列类型沿用第一段
+   * 拼接表不能再追加行，需要追加时另建扁平段后重新拼接
+   */
+  static CSVTable Concat(std::vector<std::shared_ptr<const CSVTable>> segments) {
+    CSVTable table;
+    size_t rows = 0;
+    for (const auto &segment : segments) {
+      rows += segment->size();
+      table.m_segment_ends.push_back(rows);
+    }
+    if (!segments.empty())
+      table.m_column_types = segments.front()->ColumnTypes();
+    table.m_segments = std::move(segments);
+    return table;
+  }
+  // 拼接表的各段，扁平表返回空
+  const std::vector<std::shared_ptr<const CSVTable>> &Segments() const noexcept { return m_segments; }
+  // 按存储顺序逐段调用fn(segment, first_row)，扁平表只有自身一段；热点循环可逐段取连续的数值列
+  template <typename Fn> void ForEachSegment(Fn &&fn) const {
+    if (m_segments.empty()) {
+      fn(*this, size_t{0});
+      return;
+    }
+    for (size_t i = 0; i < m_segments.size(); ++i)
+      fn(*m_segments[i], i == 0 ? size_t{0} : m_segment_ends[i - 1]);
+  }
+
+  void Reserve(size_t rows, size_t cells) {
+    m_row_offsets.reserve(rows + 1);
+    m_cells.reserve(cells);
+  }
+  // 逐单元格追加，FinishRow结束当前行
+  void AppendCell(Cell cell) { m_cells.push_back(cell); }
+  size_t PendingCellCount() const noexcept { return m_cells.size() - m_row_offsets.back(); }
+  void FinishRow() {
+    m_row_offsets.push_back(m_cells.size());
+    if (!m_column_types.empty())
+      ConvertRows(size() - 1);
+  }
+  // 丢弃尚未FinishRow的单元格
+  void DiscardPendingRow() { m_cells.resize(m_row_offsets.back()); }
+  void AppendRow(RowView row) {
+    m_cells.insert(m_cells.end(), row.begin(), row.end());
+    FinishRow();
+  }
+  // 按顺序拼接另一张表的所有行
+  void Append(const CSVTable &other) {
+    const size_t base = m_cells.size();
+    const size_t first_row = size();
+    m_cells.insert(m_cells.end(), other.m_cells.begin(), other.m_cells.end());
+    m_row_offsets.reserve(m_row_offsets.size() + other.size());
+    for (size_t i = 1; i < other.m_row_offsets.size(); ++i)
+      m_row_offsets.push_back(base + other.m_row_offsets[i]);
+    if (!m_column_types.empty())
+      ConvertRows(first_row);
+  }
+  void Clear() {
+    m_segments.clear();
+    m_segment_ends.clear();
+    m_cells.clear();
+    m_row_offsets.assign(1, 0);
+    for (auto &column : m_typed_columns) {
+      column.doubles.clear();
+      column.uints.clear();
+      column.dictionary.Clear();
+    }
+  }
+  const std::vector<Cell> &Cells() const noexcept { return m_cells; }
+  // 表自身占用的堆内存（按容量估算），不含单元格指向的源缓冲区
+  size_t MemoryBytes() const noexcept {
+    size_t bytes = m_cells.capacity() * sizeof(Cell) + m_row_offsets.capacity() * sizeof(size_t);
+    for (const auto &segment : m_segments)
+      bytes += segment->MemoryBytes();
+    for (const auto &column : m_typed_columns) {
+      bytes += column.doubles.capacity() * sizeof(double) + column.uints.capacity() * sizeof(uint32_t) +
+               column.dictionary.MemoryBytes();
+    }
+    return bytes;
+  }
+
+  /**
+   * @brief 绑定每列的类型并一次性转换已有行；之后追加的行在FinishRow时转换
+   * @param types 按列序给出的类型，未列出的列视为String
+   */
+  void BindColumnTypes(std::vector<ColumnType> types) {
+    m_column_types = std::move(types);
+    m_typed_columns.assign(m_column_types.size(), TypedColumn{});
+    for (size_t col = 0; col < m_column_types.size(); ++col) {
+      if (m_column_types[col] == ColumnType::Double)
+        m_typed_columns[col].doubles.reserve(size());
+      else if (m_column_types[col] == ColumnType::UInt32)
+        m_typed_columns[col].uints.reserve(size());
+      else if (m_column_types[col] == ColumnType::Dictionary)
+        m_typed_columns[col].dictionary.Reserve(size());
+    }
+    try {
+      for (size_t row = 0; row < size(); ++row)
+        ConvertRow(row);
+    } catch (...) {
+      m_column_types.clear();
+      m_typed_columns.clear();
+      throw;
+    }
+  }
+  ColumnType TypeOf(size_t col) const {
+    return col < m_column_types.size() ? m_column_types[col] : ColumnType::String;
+  }
+  // 数值列的连续存储，列未声明为对应类型时返回空span；多段的拼接表也返回空span，请用ForEachSegment逐段读取
+  std::span<const double> DoubleColumn(size_t col) const {
+    if (!m_segments.empty())
+      return m_segments.size() == 1 ? m_segments.front()->DoubleColumn(col) : std::span<const double>();
+    return TypeOf(col) == ColumnType::Double ? std::span<const double>(m_typed_columns[col].doubles)
+                                             : std::span<const double>();
+  }
+  std::span<const uint32_t> UInt32Column(size_t col) const {
+    if (!m_segments.empty())
+      return m_segments.size() == 1 ? m_segments.front()->UInt32Column(col) : std::span<const uint32_t>();
+    return TypeOf(col) == ColumnType::UInt32 ? std::span<const uint32_t>(m_typed_columns[col].uints)
+                                             : std::span<const uint32_t>();
+  }
+  // 字典编码列，列未声明为Dictionary时返回空列；各段的编码互不相通，多段的拼接表也返回空列
+  const DictionaryColumn &Dictionary(size_t col) const {
+    if (!m_segments.empty())
+      return m_segments.size() == 1 ? m_segments.front()->Dictionary(col) : kEmptyDictionary;
+    return TypeOf(col) == ColumnType::Dictionary ? m_typed_columns[col].dictionary : kEmptyDictionary;
+  }
+  // 读取数值单元格：优先读类型化列，未声明类型的列临时转换
+  template <typename T> T NumericAt(size_t row, size_t col) const {
+    if (!m_segments.empty()) {
+      auto [segment, local] = Locate(row);
+      return m_segments[segment]->template NumericAt<T>(local, col);
+    }
+    if constexpr (std::is_same_v<T, double>) {
+      if (TypeOf(col) == ColumnType::Double)
+        return m_typed_columns[col].doubles[row];
+    } else if constexpr (std::is_same_v<T, uint32_t>) {
+      if (TypeOf(col) == ColumnType::UInt32)
+        return m_typed_columns[col].uints[row];
+    }
+    T value{};
+    auto cells = (*this)[row];
+    if (col >= cells.size() || !CSVUtils::ParseNumber(cells[col], value))
+      throw ExceptionManager::CSVException("Invalid numeric cell at row " + std::to_string(row) + ", column " +
+                                           std::to_string(col));
+    return value;
+  }
+
+  const std::vector<ColumnType> &ColumnTypes() const noexcept { return m_column_types; }
+
+  // 类型化列的存储，只有与列类型对应的成员非空
+  struct TypedColumn {
+    std::vector<double> doubles;
+    std::vector<uint32_t> uints;
+    DictionaryColumn dictionary;
+  };
+  /**
+   * @brief 直接恢复已转换好的数值列（如从二进制快照加载），不再逐单元格转换
+   * Dictionary列由单元格重新编码，传入的dictionary成员被忽略
+   */
+  void RestoreColumnTypes(std::vector<ColumnType> types, std::vector<TypedColumn> columns) {
+    if (columns.size() != types.size())
+      throw ExceptionManager::CSVException("Typed column count mismatch");
+    for (size_t col = 0; col < types.size(); ++col) {
+      if (types[col] == ColumnType::Dictionary) {
+        auto &dictionary = columns[col].dictionary;
+        dictionary.Clear();
+        dictionary.Reserve(size());
+        for (size_t row = 0; row < size(); ++row) {
+          auto cells = (*this)[row];
+          if (col >= cells.size())
+            throw ExceptionManager::CSVException("Missing dictionary cell at row " + std::to_string(row));
+          dictionary.Append(cells[col]);
+        }
+      }
+      size_t expected_doubles = types[col] == ColumnType::Double ? size() : 0;
+      size_t expected_uints = types[col] == ColumnType::UInt32 ? size() : 0;
+      if (columns[col].doubles.size() != expected_doubles || columns[col].uints.size() != expected_uints)
+        throw ExceptionManager::CSVException("Typed column size mismatch at column " + std::to_string(col));
+    }
+    m_column_types = std::move(types);
+    m_typed_columns = std::move(columns);
+  }
+
+private:
+  // 拼接表中第row行所在的段及其段内行号；第一段通常是整张基础表，先单独判断
+  std::pair<size_t, size_t> Locate(size_t row) const {
+    if (row < m_segment_ends.front())
+      return {0, row};
+    const size_t segment = std::upper_bound(m_segment_ends.begin(), m_segment_ends.end(), row) - m_segment_ends.begin();
+    return {segment, row - m_segment_ends[segment - 1]};
+  }
+
+  void ConvertRow(size_t row) {
+    auto cells = (*this)[row];
+    for (size_t col = 0; col < m_column_types.size(); ++col) {
+      const ColumnType type = m_column_types[col];
+      if (type == ColumnType::String)
+        continue;
+      bool ok = col < cells.size();
+      if (type == ColumnType::Dictionary) {
+        if (ok)
+          m_typed_columns[col].dictionary.Append(cells[col]);
+      } else if (type == ColumnType::Double) {
+        double value = 0;
+        ok = ok && CSVUtils::ParseNumber(cells[col], value);
+        m_typed_columns[col].doubles.push_back(value);
+      } else {
+        uint32_t value = 0;
+        ok = ok && CSVUtils::ParseNumber(cells[col], value);
+        m_typed_columns[col].uints.push_back(value);
+      }
+      if (!ok)
+        throw ExceptionManager::CSVException("Invalid numeric cell at row " + std::to_string(row) +
+                                             ", column " + std::to_string(col));
+    }
+  }
+  // 转换新追加的[first_row, size())行；失败时撤销这些行，保证单元格与类型化列行数一致
+  void ConvertRows(size_t first_row) {
+    try {
+      for (size_t row = first_row; row < size(); ++row)
+        ConvertRow(row);
+    } catch (...) {
+      RollbackRows(first_row);
+      throw;
+    }
+  }
+  void RollbackRows(size_t row) {
+    for (auto &column : m_typed_columns) {
+      column.doubles.resize(std::min(column.doubles.size(), row));
+      column.uints.resize(std::min(column.uints.size(), row));
+      column.dictionary.Truncate(row);
+    }
+    m_cells.resize(m_row_offsets[row]);
+    m_row_offsets.resize(row + 1);
+  }
+
+  std::vector<Cell> m_cells;
+  std::vector<size_t> m_row_offsets{0}; // 第i行为[m_row_offsets[i], m_row_offsets[i+1])
+  std::vector<ColumnType> m_column_types;  // 为空表示未绑定类型
+  std::vector<TypedColumn> m_typed_columns; // 与m_column_types一一对应
+  std::vector<std::shared_ptr<const CSVTable>> m_segments; // 非空表示拼接表，此时自有存储为空
+  std::vector<size_t> m_segment_ends;                      // 各段末尾的累计行数
+  static inline const DictionaryColumn kEmptyDictionary{};
+};
+
+// 懒切分模式的内存占用：已切分行的单元格存储与尚未切分行的行索引分开统计
+struct LazyTableStats {
+  size_t rows = 0;
+  size_t materialized_rows = 0;
+  size_t materialized_bytes = 0;
+  size_t pending_rows = 0;
+  size_t pending_bytes = 0;
+};
+
+// 懒切分的行缓存：按行号记录已切分行的单元格，单元格存放在分块存储中，追加新行不会使已返回的行视图失效
+// Has/Get可与Store并发调用（行指针以release发布）；Store、Reset、Stats须由调用方串行
+class LazyRowCache {
+public:
+  using Cell = CSVTable::Cell;
+  using RowView = CSVTable::RowView;
+  static constexpr size_t kChunkCells = 4096;
+
+  void Reset(size_t rows) {
+    m_slots = rows ? std::make_unique<RowSlot[]>(rows) : nullptr;
+    m_rows = rows;
+    m_chunks.clear();
+    m_chunk_used = 0;
+    m_chunk_capacity = 0;
+    m_chunk_bytes = 0;
+    m_materialized_rows = 0;
+  }
+  size_t size() const noexcept { return m_rows; }
+  bool Has(size_t row) const { return m_slots[row].cells.load(std::memory_order_acquire) != nullptr; }
+  // 须在Has(row)返回true之后调用
+  RowView Get(size_t row) const {
+    return RowView(m_slots[row].cells.load(std::memory_order_acquire), m_slots[row].size);
+  }
+  RowView Store(size_t row, std::span<const Cell> cells) {
+    if (m_chunks.empty() || m_chunk_capacity - m_chunk_used < cells.size()) {
+      m_chunk_capacity = std::max(kChunkCells, cells.size());
+      m_chunks.push_back(std::make_unique<Cell[]>(m_chunk_capacity));
+      m_chunk_used = 0;
+      m_chunk_bytes += m_chunk_capacity * sizeof(Cell);
+    }
+    Cell *dest = m_chunks.back().get() + m_chunk_used;
+    std::copy(cells.begin(), cells.end(), dest);
+    m_chunk_used += cells.size();
+    // 先写列数再发布指针；空行也需要非空指针来标记已切分
+    m_slots[row].size = static_cast<uint32_t>(cells.size());
+    m_slots[row].cells.store(cells.empty() ? &kEmptyCell : dest, std::memory_order_release);
+    ++m_materialized_rows;
+    return Get(row);
+  }
+  // row_index_bytes为每个未切分行在行索引中占用的字节数
+  LazyTableStats Stats(size_t row_index_bytes) const {
+    LazyTableStats stats;
+    stats.rows = m_rows;
+    stats.materialized_rows = m_materialized_rows;
+    stats.materialized_bytes = m_chunk_bytes + m_materialized_rows * sizeof(RowSlot);
+    stats.pending_rows = stats.rows - m_materialized_rows;
+    stats.pending_bytes = stats.pending_rows * (sizeof(RowSlot) + row_index_bytes);
+    return stats;
+  }
+
+private:
+  struct RowSlot {
+    std::atomic<const Cell *> cells{nullptr}; // nullptr表示尚未切分
+    uint32_t size = 0;
+  };
+  static inline const Cell kEmptyCell{};
+
+  std::unique_ptr<RowSlot[]> m_slots;
+  size_t m_rows = 0;
+  std::vector<std::unique_ptr<Cell[]>> m_chunks;
+  size_t m_chunk_used = 0;
+  size_t m_chunk_capacity = 0;
+  size_t m_chunk_bytes = 0;
+  size_t m_materialized_rows = 0;
+};
+
+#endif // CSV_CSVTABLE_HPP
@@ -0,0 +1,131 @@
+#ifndef CSV_CSVVERSIONEDTABLE_HPP
+#define CSV_CSVVERSIONEDTABLE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "CSVStringArena.hpp"
+#include "CSVTable.hpp"
+
+/**
+ * @brief 多版本行存储：读者取不可变快照，写者基于当前版本追加行后以原子指针交换发布新版本
+ * 读者之间、读者与写者之间都不加锁；写者之间由m_write_mutex串行。
+ * 每个版本的表是若干不可变扁平段的拼接：解析所得的基础表是第一段，由同一base的所有版本共享；
+ * 追加的行落在末尾不超过kTailChunkRows行的尾段，追加时只复制这一小段，满了再另起一段。
+ * 快照同时持有单元格引用的全部存储（源文件缓冲区、追加行所在的arena），旧版本在最后一个读者释放后回收
+ */
+class VersionedTable {
+public:
+  using Snapshot = std::shared_ptr<const CSVTable>;
+  // 快照连同其版本号：同一base的各版本只在末尾追加行，前面的行保持不变，可据此增量更新派生索引
+  struct VersionedSnapshot {
+    Snapshot table;
+    uint64_t number = 0;
+    uint64_t base = 0; // 该版本所基于的Reset的版本号
+  };
+
+  // 尾段的行数上限：每次追加最多复制这么多行，与基础表大小无关
+  static constexpr size_t kTailChunkRows = 1024;
+
+  VersionedTable() : m_current(std::make_shared<const Version>()) {}
+  VersionedTable(const VersionedTable &) = delete;
+  VersionedTable &operator=(const VersionedTable &) = delete;
+
+  // 取当前版本的快照，快照存活期间其中的行视图始终有效
+  Snapshot Acquire() const {
+    auto version = m_current.load(std::memory_order_acquire);
+    return Snapshot(version, &version->table);
+  }
+  uint64_t VersionNumber() const { return m_current.load(std::memory_order_acquire)->number; }
+  VersionedSnapshot AcquireVersioned() const {
+    auto version = m_current.load(std::memory_order_acquire);
+    return {Snapshot(version, &version->table), version->number, version->base};
+  }
+
+  /**
+   * @brief 以新解析的表替换全部内容，source为表中单元格指向的缓冲区
+   * 同时换用新的arena：旧版本追加的行随旧版本一起回收，内存在最后一个持有旧快照的读者释放后归还
+   */
+  void Reset(CSVTable table, std::shared_ptr<const void> source) {
+    std::lock_guard<std::mutex> lock(m_write_mutex);
+    auto next = std::make_shared<Version>();
+    next->table = CSVTable::Concat({std::make_shared<const CSVTable>(std::move(table))});
+    next->source = std::move(source);
+    next->number = m_current.load(std::memory_order_relaxed)->number + 1;
+    next->base = next->number;
+    m_arena = std::make_shared<StringArena>();
+    next->arena = m_arena;
+    Publish(std::move(next));
+  }
+
+  /**
+   * @brief 追加rows后发布新版本；字符串拷贝进只追加的arena，已发布的视图不会失效
+   * 基础表与已满的尾段在新旧版本间共享，只复制未满的尾段。类型转换失败时抛异常，当前版本与arena均不变
+   */
+  Snapshot AppendRows(const std::vector<std::vector<std::string>> &rows) {
+    std::lock_guard<std::mutex> lock(m_write_mutex);
+    auto current = m_current.load(std::memory_order_relaxed);
+    auto segments = current->table.Segments();
+    auto tail = std::make_shared<CSVTable>();
+    if (!current->table.ColumnTypes().empty())
+      tail->BindColumnTypes(current->table.ColumnTypes());
+    // 第一段是基础表，不并入尾段
+    if (segments.size() > 1 && segments.back()->size() < kTailChunkRows) {
+      tail->Append(*segments.back());
+      segments.pop_back();
+    }
+    const auto mark = m_arena->GetMark();
+    try {
+      std::vector<std::string_view> rowView;
+      for (const auto &row : rows) {
+        rowView.clear();
+        for (const auto &cell : row)
+          rowView.push_back(m_arena->Store(cell));
+        tail->AppendRow(rowView);
+      }
+    } catch (...) {
+      m_arena->Rollback(mark);
+      throw;
+    }
+    segments.push_back(std::move(tail));
+
+    auto next = std::make_shared<Version>();
+    next->table = CSVTable::Concat(std::move(segments));
+    next->source = current->source;
+    next->arena = m_arena;
+    next->number = current->number + 1;
+    next->base = current->base;
+    Publish(next);
+    return Snapshot(next, &next->table);
+  }
+
+  // 当前arena中追加行字符串的占用，reload后归零
+  size_t ArenaBytes() const {
+    std::lock_guard<std::mutex> lock(m_write_mutex);
+    return m_arena->ReservedBytes();
+  }
+
+private:
+  struct Version {
+    CSVTable table;                            // 各段的拼接，段本身不可变
+    std::shared_ptr<const void> source;        // 解析所得单元格指向的缓冲区
+    std::shared_ptr<const StringArena> arena;  // 追加行的单元格指向这里
+    uint64_t number = 0;
+    uint64_t base = 0;
+  };
+
+  // 发布新版本；读者load得到的旧版本由其引用计数保活
+  void Publish(std::shared_ptr<const Version> next) { m_current.store(std::move(next), std::memory_order_release); }
+
+  // 读者只做一次原子load，不经libstdc++按地址散列的全局互斥锁池
+  std::atomic<std::shared_ptr<const Version>> m_current;
+  std::shared_ptr<StringArena> m_arena = std::make_shared<StringArena>(); // 受m_write_mutex保护
+  mutable std::mutex m_write_mutex;
+};
+
+#endif // CSV_CSVVERSIONEDTABLE_HPP
@@ -0,0 +1,80 @@
+#ifndef CSV_CSVWRITER_HPP
+#define CSV_CSVWRITER_HPP
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+
+#include "CSVAtomicFile.hpp"
+#include "CSVTable.hpp"
+#include "ExceptionManager.hpp"
+
+// 缓冲写出：整行格式化到可复用的大缓冲区，攒满后整块write，避免逐单元格、逐行flush
+class CSVWriter {
+public:
+  static constexpr size_t kDefaultBufferSize = 1 << 20;
+
+  explicit CSVWriter(size_t buffer_size = kDefaultBufferSize) : m_flush_size(std::max<size_t>(buffer_size, 4096)) {
+    m_buffer.reserve(m_flush_size + 4096);
+  }
+
+  /**
+   * @brief 整表写出：先写同目录下的临时文件，fdatasync后rename覆盖目标，读者不会看到写了一半的文件
+   * @param header 首行列名，为空时不写首行
+   */
+  void WriteTable(const std::string &path, const std::vector<std::string_view> &header, const CSVTable &table) {
+    m_buffer.clear();
+    CSVUtils::AtomicFile file(path);
+    if (!header.empty())
+      FormatRow(header);
+    WriteRows(file.Sink(), table, 0);
+    file.Commit();
+  }
+
+  /**
+   * @brief 追加写出[first_row, table.size())行，已有内容不重写；文件末尾缺换行时先补一个
+   */
+  void AppendRows(const std::string &path, const CSVTable &table, size_t first_row) {
+    if (first_row >= table.size())
+      return;
+    m_buffer.clear();
+    FileSink sink(path, O_WRONLY | O_APPEND);
+    if (!sink.EndsWithNewline())
+      m_buffer.push_back('\n');
+    WriteRows(sink, table, first_row);
+    sink.Sync();
+    sink.Close();
+  }
+
+private:
+  using FileSink = CSVUtils::FileSink;
+
+  template <typename Row> void FormatRow(const Row &row) {
+    for (size_t i = 0; i < row.size(); ++i) {
+      if (i != 0)
+        m_buffer.push_back(',');
+      m_buffer.append(row[i]);
+    }
+    m_buffer.push_back('\n');
+  }
+  // 单元格原样拷贝：数值列在加载时已校验过，原文即可无损写回，无需再经to_chars格式化
+  void WriteRows(FileSink &sink, const CSVTable &table, size_t first_row) {
+    for (size_t row = first_row; row < table.size(); ++row) {
+      FormatRow(table[row]);
+      if (m_buffer.size() >= m_flush_size) {
+        sink.Write(m_buffer);
+        m_buffer.clear();
+      }
+    }
+    sink.Write(m_buffer);
+    m_buffer.clear();
+  }
+
+  size_t m_flush_size;
+  std::string m_buffer;
+};
+
+#endif // CSV_CSVWRITER_HPP
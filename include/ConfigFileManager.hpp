@@ -7,44 +7,7 @@
 #include <string>
 #include <unordered_map>
 
-class TreeNode {
-public:
-  TreeNode(const std::string &name, const std::string &filePath = "")
-      : name(name), filePath(filePath) {}
-
-  void addChild(const std::string &childName,
-                const std::shared_ptr<TreeNode> &child) {
-    children[childName] = child;
-  }
-
-  std::shared_ptr<TreeNode> getChild(const std::string &childName) const {
-    auto it = children.find(childName);
-    if (it != children.end()) {
-      return it->second;
-    }
-    return nullptr;
-  }
-
-  const std::string &getFilePath() const { return filePath; }
-
-  void printTree(int level = 0) const {
-    for (int i = 0; i < level; ++i)
-      std::cout << "  ";
-    std::cout << name;
-    if (!filePath.empty()) {
-      std::cout << " (" << filePath << ")";
-    }
-    std::cout << std::endl;
-    for (const auto &[key, child] : children) {
-      child->printTree(level + 1);
-    }
-  }
-
-private:
-  std::string name;
-  std::string filePath;
-  std::unordered_map<std::string, std::shared_ptr<TreeNode>> children;
-};
+#include "CFGFileTree.hpp"
 
 class ConfigFileManager {
 public:
@@ -100,7 +63,7 @@ public:
                                fullPath.string());
     }
 
-    auto current = root;
+    auto current = CFGFileTree::kRoot;
 
     // 解析路径中的目录结构
     size_t pos = 0;
@@ -109,19 +72,18 @@ public:
 
     while ((pos = remainingPath.find('/')) != std::string::npos) {
       token = remainingPath.substr(0, pos);
-      if (!current->getChild(token)) {
-        current->addChild(token, std::make_shared<TreeNode>(token));
+      current = tree.AddDirectory(current, token);
+      if (current == CFGFileTree::kNoNode) {
+        throw std::runtime_error("Path component is a file: " + token);
       }
-      current = current->getChild(token);
       remainingPath.erase(0, pos + 1);
     }
 
     // 最后一个节点：当前目录的文件或目录
-    if (!current->getChild(remainingPath)) {
-      current->addChild(remainingPath,
-                        std::make_shared<TreeNode>(remainingPath, filePath));
-    } else {
-      current->getChild(remainingPath)->setFilePath(filePath);
+    auto node = filePath.empty() ? tree.AddDirectory(current, remainingPath)
+                                 : tree.AddFile(current, remainingPath, filePath);
+    if (node == CFGFileTree::kNoNode) {
+      throw std::runtime_error("Conflicting node type for: " + relativePath);
     }
   }
 
@@ -153,12 +115,25 @@ public:
       throw std::runtime_error("Root path is not set. Cannot print tree.");
     }
     std::cout << "Root Path: " << rootPath << std::endl;
-    root->printTree();
+    printTree(CFGFileTree::kRoot, 0);
   }
 
 private:
-  ConfigFileManager()
-      : root(std::make_shared<TreeNode>("Root")), isRootPathSet(false) {}
+  ConfigFileManager() : tree("Root"), isRootPathSet(false) {}
+
+  void printTree(CFGFileTree::NodeIndex index, int level) const {
+    for (int i = 0; i < level; ++i)
+      std::cout << "  ";
+    std::cout << tree.Name(index);
+    if (tree.IsFile(index)) {
+      std::cout << " (" << tree.FilePath(index) << ")";
+    }
+    std::cout << std::endl;
+    for (auto child = tree.FirstChild(index); child != CFGFileTree::kNoNode;
+         child = tree.NextSibling(child)) {
+      printTree(child, level + 1);
+    }
+  }
 
   static std::string normalizePath(const std::string &rawPath) {
     std::filesystem::path p(rawPath);
@@ -166,7 +141,7 @@ private:
   }
 
   std::string rootPath;
-  std::shared_ptr<TreeNode> root;
+  CFGFileTree tree; // 扁平节点树，节点与名字连续存放
   bool isRootPathSet; // 标志 rootPath 是否已经设置
 };
 
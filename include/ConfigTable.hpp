@@ -3,6 +3,7 @@
 
 #include "ModuleParser.hpp"
 
+#include <atomic>
 #include <filesystem>
 #include <functional>
 #include <iostream>
@@ -81,6 +82,9 @@ private:
 };
 
 // CFGFileManager 单例管理配置文件
+// 读多写少：GetParser只原子读取不可变的注册表快照，不加锁；
+// 写者（SetRootPath、LoadCFGFile、LoadAllCFGFiles、RegisterModuleParser、首次创建解析器）
+// 由mWriteMutex串行，复制当前注册表、修改后原子发布，持有旧快照的读者不受影响
 class CFGFileManager {
 public:
   using ParserCreator =
@@ -95,7 +99,7 @@ public:
   CFGFileManager &operator=(const CFGFileManager &) = delete;
 
   void SetRootPath(const std::string &root_path) {
-    std::lock_guard<std::mutex> lock(mMutex); // 加锁，确保线程安全
+    std::lock_guard<std::mutex> lock(mWriteMutex);
     if (root_path.empty()) {
       throw std::runtime_error("Root path cannot be empty!");
     }
@@ -106,20 +110,30 @@ public:
         !std::filesystem::is_directory(absolutePath)) {
       throw std::runtime_error("Invalid root path: " + root_path);
     }
-    mRootPath = absolutePath.string();
-    mRootNode = std::make_shared<CFGFileNode>(mRootPath);
+    auto next = CopyRegistry();
+    next->rootPath = absolutePath.string();
+    Publish(std::move(next));
+    mRootNode = std::make_shared<CFGFileNode>(absolutePath.string());
   }
 
   void LoadCFGFile(const std::string &moduleName, const std::string &fileName) {
-    std::lock_guard<std::mutex> lock(mMutex); // 加锁，确保线程安全
-    if (mRootPath.empty()) {
+    std::lock_guard<std::mutex> lock(mWriteMutex);
+    auto next = CopyRegistry();
+    if (next->rootPath.empty()) {
       throw std::runtime_error("Root path is not set!");
     }
-    std::string fullPath = mRootPath + "/" + moduleName + "/" + fileName;
+    std::string fullPath = next->rootPath + "/" + moduleName + "/" + fileName;
     if (!std::filesystem::exists(fullPath)) {
       throw std::runtime_error("Config file does not exist: " + fullPath);
     }
 
+    auto it = next->parserCreators.find(moduleName);
+    if (it == next->parserCreators.end()) {
+      throw std::runtime_error("No parser registered for module: " +
+                               moduleName);
+    }
+    next->cfgParsers[fullPath] = it->second(fullPath);
+
     auto moduleNode = mRootNode->GetChild(moduleName);
     if (!moduleNode) {
       moduleNode = std::make_shared<CFGFileNode>(moduleName);
@@ -127,62 +141,57 @@ public:
     }
     auto fileNode = std::make_shared<CFGFileNode>(fileName, fullPath);
     moduleNode->AddChild(fileName, fileNode);
-
-    auto it = mParserCreators.find(moduleName);
-    if (it != mParserCreators.end()) {
-      throw std::runtime_error("Module parser already registered: " +
-                               moduleName);
-    }
-    auto parser = it->second(fullPath);
-    mCFGParsers[fullPath] = std::move(parser);
+    Publish(std::move(next));
   }
 
   void LoadAllCFGFiles() {
-    std::lock_guard<std::mutex> lock(mMutex); // 加锁，确保线程安全
-    if (mRootPath.empty()) {
+    std::lock_guard<std::mutex> lock(mWriteMutex);
+    auto next = CopyRegistry();
+    if (next->rootPath.empty()) {
       throw std::runtime_error("Root path is not set!");
     }
-    mRootNode->ScanAndAddFiles(mRootPath, mParserCreators, mCFGParsers);
+    mRootNode->ScanAndAddFiles(next->rootPath, next->parserCreators,
+                               next->cfgParsers);
+    Publish(std::move(next));
   }
 
   void RegisterModuleParser(const std::string &moduleName,
                             ParserCreator parser) {
-    std::lock_guard<std::mutex> lock(mMutex); // 加锁，确保线程安全
-    mParserCreators[moduleName] = std::move(parser);
+    std::lock_guard<std::mutex> lock(mWriteMutex);
+    auto next = CopyRegistry();
+    next->parserCreators[moduleName] = std::move(parser);
+    Publish(std::move(next));
   }
 
   ModuleParser::ModuleParserPtr GetParser(const std::string &parentNodeName,
                                           const std::string &fileName) {
-    std::lock_guard<std::mutex> lock(mMutex); // 加锁，确保线程安全
-
+    auto registry = Acquire();
     // 构造完整的文件路径
-    std::string fullPath = mRootPath + "/" + parentNodeName + "/" + fileName;
-    std::cout << "Full path: " << fullPath << std::endl;
+    std::string fullPath =
+        registry->rootPath + "/" + parentNodeName + "/" + fileName;
+
+    // 检查快照中是否已有该解析器，命中时不加锁
+    auto it = registry->cfgParsers.find(fullPath);
+    if (it != registry->cfgParsers.end()) {
+      return it->second;
+    }
 
     // 校验路径是否存在
     if (!std::filesystem::exists(fullPath)) {
       std::cerr << "Error: File does not exist: " << fullPath << std::endl;
       return nullptr; // 或者抛出异常
     }
-
-    // 检查缓存中是否已有该解析器
-    auto it = mCFGParsers.find(fullPath);
-    if (it != mCFGParsers.end()) {
-      return it->second;
-    }
-
-    // 延迟创建解析器
-    auto parserCreatorIt = mParserCreators.find(parentNodeName);
-    if (parserCreatorIt != mParserCreators.end()) {
-      auto parser = parserCreatorIt->second(fullPath);
-      mCFGParsers[fullPath] = parser;
-      return parser;
-    }
-
-    return nullptr;
+    return CreateParser(parentNodeName, fullPath);
   }
 
 private:
+  // 不可变注册表，发布后只读
+  struct Registry {
+    std::string rootPath;
+    std::unordered_map<std::string, ParserCreator> parserCreators;
+    std::unordered_map<std::string, ModuleParser::ModuleParserPtr> cfgParsers;
+  };
+
   CFGFileManager() {
     RegisterModuleParser("PLL", [](const std::string &cfg) {
       return std::make_shared<PLLParser>(cfg);
@@ -205,17 +214,51 @@ private:
     });
   }
 
+  // 延迟创建解析器：写者持锁后复查，并发首次访问同一文件时只创建一次
+  ModuleParser::ModuleParserPtr CreateParser(const std::string &moduleName,
+                                             const std::string &fullPath) {
+    std::lock_guard<std::mutex> lock(mWriteMutex);
+    auto current = Acquire();
+    auto it = current->cfgParsers.find(fullPath);
+    if (it != current->cfgParsers.end()) {
+      return it->second;
+    }
+    auto parserCreatorIt = current->parserCreators.find(moduleName);
+    if (parserCreatorIt == current->parserCreators.end()) {
+      return nullptr;
+    }
+    std::cout << "Full path: " << fullPath << std::endl;
+    auto parser = parserCreatorIt->second(fullPath);
+    auto next = std::make_shared<Registry>(*current);
+    next->cfgParsers[fullPath] = parser;
+    Publish(std::move(next));
+    return parser;
+  }
+
+  std::shared_ptr<const Registry> Acquire() const {
+    return mRegistry.load(std::memory_order_acquire);
+  }
+  // 以下两个函数只能在持有mWriteMutex时调用
+  std::shared_ptr<Registry> CopyRegistry() const {
+    return std::make_shared<Registry>(
+        *mRegistry.load(std::memory_order_relaxed));
+  }
+  void Publish(std::shared_ptr<const Registry> next) {
+    mRegistry.store(std::move(next), std::memory_order_release);
+  }
+
   std::string NormalizePath(const std::string &rawPath) {
     std::filesystem::path path(rawPath);
     path = std::filesystem::weakly_canonical(path);
     return path.generic_string();
   }
 
-  std::string mRootPath;
-  CFGFileNode::FileNodePtr mRootNode;
-  std::unordered_map<std::string, ParserCreator> mParserCreators;
-  std::unordered_map<std::string, ModuleParser::ModuleParserPtr> mCFGParsers;
-  std::mutex mMutex; // 用于确保线程安全
+  // 读者只做一次原子load，竞争只落在本注册表自己的控制字上，
+  // 不经自由函数atomic_load所用的libstdc++全局互斥锁池
+  std::atomic<std::shared_ptr<const Registry>> mRegistry{
+      std::make_shared<const Registry>()};
+  CFGFileNode::FileNodePtr mRootNode; // 受mWriteMutex保护
+  std::mutex mWriteMutex;             // 串行化写者
 };
 
 #endif
\ No newline at end of file
@@ -23,7 +23,7 @@ public:
   explicit ModuleParser(const std::string &moduleName) : m_moduleName(moduleName) {}
   virtual ~ModuleParser() = default;
   virtual void parse() = 0;
-  virtual CSVParser::DataContainer GetModuleCFGData() const = 0;
+  virtual const CSVParser::DataContainer &GetModuleCFGData() const = 0;
   const std::string &GetModuleName() const { return m_moduleName; }
 
 protected:
@@ -35,7 +35,7 @@ public:
   explicit PLLParser(const std::string &cfg) : ModuleParser("PLL"), m_cfg(cfg), m_parser(ParseMode::Synchronous) {}
 
   void parse() override { m_parser.ParseDataFromCSV(m_cfg); }
-  CSVParser::DataContainer GetModuleCFGData() const override { return m_parser.GetCSVData(); }
+  const CSVParser::DataContainer &GetModuleCFGData() const override { return m_parser.GetCSVData(); }
 
 private:
   std::string m_cfg;
@@ -46,7 +46,7 @@ class DACParser : public ModuleParser {
 public:
   explicit DACParser(const std::string &cfg) : ModuleParser("DAC"), m_cfg(cfg), m_parser(ParseMode::Synchronous) {}
   void parse() override { m_parser.ParseDataFromCSV(m_cfg); }
-  CSVParser::DataContainer GetModuleCFGData() const override { return m_parser.GetCSVData(); }
+  const CSVParser::DataContainer &GetModuleCFGData() const override { return m_parser.GetCSVData(); }
 
 private:
   std::string m_cfg;
@@ -57,7 +57,7 @@ class ModParser : public ModuleParser {
 public:
   explicit ModParser(const std::string &cfg) : ModuleParser("MOD"), m_cfg(cfg), m_parser(ParseMode::Synchronous) {}
   void parse() override { m_parser.ParseDataFromCSV(m_cfg); }
-  CSVParser::DataContainer GetModuleCFGData() const override { return m_parser.GetCSVData(); }
+  const CSVParser::DataContainer &GetModuleCFGData() const override { return m_parser.GetCSVData(); }
 
 private:
   std::string m_cfg;
@@ -68,7 +68,7 @@ class SGCParser : public ModuleParser {
 public:
   explicit SGCParser(const std::string &cfg) : ModuleParser("SGC"), m_cfg(cfg), m_parser(ParseMode::Synchronous) {}
   void parse() override { m_parser.ParseDataFromCSV(m_cfg); }
-  CSVParser::DataContainer GetModuleCFGData() const override { return m_parser.GetCSVData(); }
+  const CSVParser::DataContainer &GetModuleCFGData() const override { return m_parser.GetCSVData(); }
 
 private:
   std::string m_cfg;
@@ -79,7 +79,7 @@ class FEParser : public ModuleParser {
 public:
   explicit FEParser(const std::string &cfg) : ModuleParser("FE"), m_cfg(cfg), m_parser(ParseMode::Synchronous) {}
   void parse() override { m_parser.ParseDataFromCSV(m_cfg); }
-  CSVParser::DataContainer GetModuleCFGData() const override { return m_parser.GetCSVData(); }
+  const CSVParser::DataContainer &GetModuleCFGData() const override { return m_parser.GetCSVData(); }
 
 private:
   std::string m_cfg;
@@ -90,7 +90,7 @@ class RECParser : public ModuleParser {
 public:
   explicit RECParser(const std::string &cfg) : ModuleParser("REC"), m_cfg(cfg), m_parser(ParseMode::Synchronous) {}
   void parse() override { m_parser.ParseDataFromCSV(m_cfg); }
-  CSVParser::DataContainer GetModuleCFGData() const override { return m_parser.GetCSVData(); }
+  const CSVParser::DataContainer &GetModuleCFGData() const override { return m_parser.GetCSVData(); }
 
 private:
   std::string m_cfg;
@@ -0,0 +1,179 @@
+#ifndef CFGBUNDLE_HPP
+#define CFGBUNDLE_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "../CSVAtomicFile.hpp"
+#include "CFGFileNode.hpp"
+#include "CFGFileParser.hpp"
+
+/**
+ * @brief 配置包(.cfgbundle)：把整个Configs目录树打成一个可映射的文件
+ * 布局为 头部 | 各文件的源内容与快照映像（8字节对齐）| 目录表 | 名字区。
+ * 快照映像沿用.csvbin格式（CSVUtils::BinaryCache），单元格直接指向包内的源内容；
+ * 加载时只映射一次文件，目录表校验哈希，各表的映像在解析时再各自校验
+ */
+class CFGBundle {
+public:
+  static constexpr char kMagic[8] = {'C', 'F', 'G', 'B', 'N', 'D', 'L', '\1'};
+  static constexpr uint32_t kVersion = 1;
+  static constexpr const char *kExtension = ".cfgbundle";
+
+  struct Entry {
+    std::string_view moduleName;
+    std::string_view fileName;
+    std::string_view content; // 源CSV内容
+    std::string_view image;   // .csvbin格式的快照映像
+  };
+  // 打包输入，由CFGFileManager::WriteBundle逐文件解析得到
+  struct Source {
+    std::string moduleName;
+    std::string fileName;
+    std::string content;
+    std::string image;
+  };
+
+  // 文件以配置包的魔数开头
+  static bool IsBundle(const std::string &path) {
+    std::ifstream in(path, std::ios::binary);
+    char magic[sizeof(kMagic)] = {};
+    return in.read(magic, sizeof(magic)) && std::memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+  }
+
+  explicit CFGBundle(const std::string &path) : m_path(path) {
+    try {
+      m_mapping = std::make_shared<MemoryMap>(path);
+    } catch (const ExceptionManager::CSVException &) {
+      throw CFGFileNodeException("Cannot open config bundle: " + path);
+    }
+    ReadIndex(m_mapping->View());
+  }
+
+  const std::string &GetPath() const { return m_path; }
+  const std::vector<Entry> &Entries() const { return m_entries; }
+  const Entry *Find(const std::string &moduleName, const std::string &fileName) const {
+    auto it = m_index.find(moduleName + "/" + fileName);
+    return it == m_index.end() ? nullptr : &m_entries[it->second];
+  }
+  // 交给解析器的映像，映射随解析结果保活
+  CFGTableImage Image(const Entry &entry) const { return {m_mapping, entry.content, entry.image}; }
+
+  // 经AtomicFile写出（独占临时文件、fdatasync后改名），正在使用旧包的进程与崩溃后的读者只会看到完整的包
+  static void Write(const std::string &path, const std::vector<Source> &sources) {
+    BundleHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.endian_tag = CSVUtils::BinaryCache::kEndianTag;
+    header.entry_count = sources.size();
+
+    std::string data;
+    std::string names;
+    std::vector<IndexEntry> index;
+    auto append = [&data](const std::string &blob) {
+      uint64_t offset = sizeof(BundleHeader) + data.size();
+      data += blob;
+      CSVUtils::BinaryCache::PadTo8(data);
+      return offset;
+    };
+    for (const auto &source : sources) {
+      IndexEntry entry{};
+      entry.name_offset = names.size();
+      entry.module_length = static_cast<uint32_t>(source.moduleName.size());
+      entry.file_length = static_cast<uint32_t>(source.fileName.size());
+      names += source.moduleName;
+      names += source.fileName;
+      entry.content_size = source.content.size();
+      entry.content_offset = append(source.content);
+      entry.image_size = source.image.size();
+      entry.image_offset = append(source.image);
+      index.push_back(entry);
+    }
+    std::string table;
+    CSVUtils::BinaryCache::AppendPod(table, index.data(), index.size());
+    table += names;
+    header.index_offset = sizeof(BundleHeader) + data.size();
+    header.index_size = table.size();
+    header.names_offset = index.size() * sizeof(IndexEntry);
+    header.index_hash = CSVUtils::BinaryCache::HashBytes(table);
+
+    try {
+      CSVUtils::AtomicFile file(path);
+      file.Write({reinterpret_cast<const char *>(&header), sizeof(header)});
+      file.Write(data);
+      file.Write(table);
+      file.Commit();
+    } catch (const ExceptionManager::CSVException &ex) {
+      throw CFGFileNodeException("Cannot write config bundle: " + path + " (" + ex.what() + ")");
+    }
+  }
+
+private:
+  struct BundleHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t endian_tag;
+    uint64_t entry_count;
+    uint64_t index_offset; // 目录表（IndexEntry数组 + 名字区）在包内的位置
+    uint64_t index_size;
+    uint64_t names_offset; // 名字区相对目录表的偏移
+    uint64_t index_hash;
+  };
+  struct IndexEntry {
+    uint64_t name_offset; // 名字区中依次存放模块名与文件名
+    uint32_t module_length;
+    uint32_t file_length;
+    uint64_t content_offset;
+    uint64_t content_size;
+    uint64_t image_offset;
+    uint64_t image_size;
+  };
+
+  void ReadIndex(std::string_view bundle) {
+    BundleHeader header{};
+    if (bundle.size() < sizeof(header))
+      Corrupted();
+    std::memcpy(&header, bundle.data(), sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion ||
+        header.endian_tag != CSVUtils::BinaryCache::kEndianTag || header.index_offset > bundle.size() ||
+        header.index_size != bundle.size() - header.index_offset)
+      Corrupted();
+    std::string_view table = bundle.substr(header.index_offset);
+    if (CSVUtils::BinaryCache::HashBytes(table) != header.index_hash ||
+        header.entry_count > table.size() / sizeof(IndexEntry) ||
+        header.names_offset != header.entry_count * sizeof(IndexEntry))
+      Corrupted();
+    std::string_view names = table.substr(header.names_offset);
+    auto slice = [&](std::string_view from, uint64_t offset, uint64_t size) {
+      if (offset > from.size() || size > from.size() - offset)
+        Corrupted();
+      return from.substr(offset, size);
+    };
+    m_entries.reserve(header.entry_count);
+    for (uint64_t i = 0; i < header.entry_count; ++i) {
+      IndexEntry index{};
+      std::memcpy(&index, table.data() + i * sizeof(IndexEntry), sizeof(index));
+      Entry entry;
+      entry.moduleName = slice(names, index.name_offset, index.module_length);
+      entry.fileName = slice(names, index.name_offset + index.module_length, index.file_length);
+      entry.content = slice(bundle, index.content_offset, index.content_size);
+      entry.image = slice(bundle, index.image_offset, index.image_size);
+      m_index.emplace(std::string(entry.moduleName) + "/" + std::string(entry.fileName), m_entries.size());
+      m_entries.push_back(entry);
+    }
+  }
+  [[noreturn]] void Corrupted() const { throw CFGFileNodeException("Corrupted config bundle: " + m_path); }
+
+  std::string m_path;
+  std::shared_ptr<const MemoryMap> m_mapping;
+  std::vector<Entry> m_entries;
+  std::unordered_map<std::string, size_t> m_index; // "模块/文件" -> m_entries下标
+};
+
+#endif // CFGBUNDLE_HPP
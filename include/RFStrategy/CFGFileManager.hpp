@@ -1,27 +1,59 @@
 #ifndef CFGFILEMANAGER_HPP
 #define CFGFILEMANAGER_HPP
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <filesystem>
 #include <functional>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <tuple>
 #include <unordered_map>
+#include <vector>
 
+#include "../ThreadPool.hpp"
+#include "CFGBundle.hpp"
 #include "CFGFileNode.hpp"
+#include "CFGLoadReport.hpp"
 #include "CFGFileParser.hpp"
+#include "CFGFileWatcher.hpp"
 
 class CFGFileManager {
 public:
   using ParserCreator = std::function<CFGFileParser::CFGFileParserPtr(const std::string &)>;
   using ParserCreatorMap = std::unordered_map<std::string, ParserCreator>;
   using CFGParserMap = std::unordered_map<std::string, CFGFileParser::CFGFileParserPtr>;
+  // (模块, 文件)驻留后的句柄：解析器表的下标，SetRootPath/Clear后依然有效
+  using ParserHandle = uint32_t;
+  static constexpr ParserHandle kInvalidParserHandle = UINT32_MAX;
+  // 解析器缓存的命中与淘汰计数，用于确定内存预算
+  struct CFGCacheStats {
+    uint64_t hits = 0;   // 无锁命中，按槽位计数，取统计时汇总
+    uint64_t misses = 0; // 首次GetParser时按需创建并解析
+    uint64_t evictions = 0;
+    uint64_t reloads = 0; // 文件变更后重新解析并替换的次数
+    size_t residentParsers = 0;
+    size_t residentBytes = 0; // 按各解析器登记（加载或重新加载）时的占用累计
+    size_t budgetBytes = 0; // 0表示不限
+  };
+
   static CFGFileManager &GetInstance() {
     static CFGFileManager instance;
     return instance;
   }
   CFGFileManager(const CFGFileManager &) = delete;
   CFGFileManager &operator=(const CFGFileManager &) = delete;
+  /**
+   * @brief 设置配置根：包含Configs目录的目录，或由WriteBundle生成的配置包文件
+   * 配置包模式下节点树直接由包的目录表建立，之后的加载只读映射，不再逐文件访问文件系统。
+   * 正在监视时切换到新的目录后在新根上继续监视（沿用原settle）；配置包不可监视，切换到配置包后监视停止，
+   * 可由IsWatching()确认。新根无法监视时根已切换，抛出的异常表示监视未恢复
+   */
   void SetRootPath(const std::string &root_path) {
     if (root_path.empty()) {
       throw CFGFileNodeException("Root path cannot be empty!");
@@ -31,70 +63,204 @@ public:
     if (!std::filesystem::exists(absolutePath)) {
       throw CFGFileNodeException("Root path does not exist: " + normalizedPath);
     }
-    if (!std::filesystem::is_directory(absolutePath)) {
+    std::shared_ptr<const CFGBundle> bundle;
+    if (std::filesystem::is_regular_file(absolutePath) && CFGBundle::IsBundle(absolutePath.string())) {
+      bundle = std::make_shared<const CFGBundle>(absolutePath.string());
+    } else if (!std::filesystem::is_directory(absolutePath)) {
       throw CFGFileNodeException("Root path is not a directory: " + normalizedPath);
     }
-    this->mRootPath = absolutePath.string() + "/Configs";
-    mRootNode = CFGFileNode::Create(this->mRootPath);
+    const bool wasWatching = IsWatching();
+    StopWatching();
+    {
+      std::lock_guard<std::mutex> lock(mParserMutex);
+      // 配置包内文件的路径形如 <包路径>/FE/FE1.csv，只作标识，不对应磁盘文件
+      this->mRootPath = bundle ? absolutePath.string() : absolutePath.string() + "/Configs";
+      mBundle = std::move(bundle);
+      mTree.Reset(this->mRootPath);
+      if (mBundle) {
+        for (const auto &entry : mBundle->Entries()) {
+          const std::string moduleName(entry.moduleName), fileName(entry.fileName);
+          AddFileNodeLocked(moduleName, fileName, MakeFullPath(moduleName, fileName));
+        }
+      }
+      // 已驻留的句柄保留，解析器在新根目录下重新加载
+      for (auto &slot : mSlots) {
+        DropParserLocked(*slot);
+        slot->fullPath = MakeFullPath(slot->moduleName, slot->fileName);
+      }
+    }
+    if (wasWatching && !mBundle)
+      StartWatching(mWatchSettle);
   }
 
   void LoadCFGFile(const std::string &moduleName, const std::string &fileName) {
     EnsureRootPathSet();
     // 构造文件的完整路径
     std::string fullPath = mRootPath + "/" + moduleName + "/" + fileName;
-    if (!std::filesystem::exists(fullPath)) {
+    if (!FileExists(moduleName, fileName, fullPath)) {
       throw CFGFileNodeException("Config file does not exist: " + fullPath);
     }
-    // 查找或创建模块节点
-    auto moduleNode = mRootNode->GetChild(moduleName);
-    if (!moduleNode) {
-      moduleNode = CFGFileNode::Create(moduleName);
-      mRootNode->AddChild(moduleName, moduleNode);
+    // 解析在锁外进行，结果记入加载报告
+    CFGFileLoadStat stat;
+    stat.path = fullPath;
+    CFGFileParser::CFGFileParserPtr parser;
+    try {
+      parser = LoadParser(moduleName, fileName, stat);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mParserMutex);
+      RecordLoadLocked(stat);
+      throw;
     }
-
-    auto fileNode = CFGFileNode::Create(fileName, fullPath);
-    moduleNode->AddChild(fileName, fileNode);
-
-    auto it = mParserCreators.find(moduleName);
-    if (it == mParserCreators.end()) {
-      throw CFGFileNodeException("No parser registered for module: " + moduleName);
-    }
-    auto parser = it->second(fullPath);
-    mCFGParsers.try_emplace(fullPath, std::move(parser));
+    const size_t bytes = parser->MemoryBytes();
+    std::lock_guard<std::mutex> lock(mParserMutex);
+    RecordLoadLocked(stat);
+    // 查找或创建模块节点
+    AddFileNodeLocked(moduleName, fileName, fullPath);
+    auto handle = ResolveLocked(moduleName, fileName);
+    InstallParserLocked(handle, std::move(parser), bytes);
+    EnforceBudgetLocked(handle);
   }
 
   // 获取文件路径
   std::string GetCFGFilePath(const std::string &moduleName, const std::string &fileName) const {
     EnsureRootPathSet();
-
-    auto moduleNode = mRootNode->GetChild(moduleName);
-    if (!moduleNode) {
-      throw CFGFileNodeException("Module not found: " + moduleName);
-    }
-
-    auto fileNode = moduleNode->GetChild(fileName);
-    if (!fileNode || !fileNode->isFile()) {
+    std::lock_guard<std::mutex> lock(mParserMutex);
+    auto fileNode = mTree.FindPath(moduleName, fileName);
+    if (fileNode == CFGFileTree::kNoNode || !mTree.IsFile(fileNode)) {
+      if (mTree.Find(CFGFileTree::kRoot, moduleName) == CFGFileTree::kNoNode)
+        throw CFGFileNodeException("Module not found: " + moduleName);
       throw CFGFileNodeException("File not found in module: " + fileName);
     }
-
-    return fileNode->GetFilePath();
+    return std::string(mTree.FilePath(fileNode));
   }
 
-  CFGFileNode::FileNodePtr GetRootNode() const { return mRootNode; }
+  // 监视文件变更期间节点树会被后台线程修改，此时请通过GetCFGFilePath查询；未设置根目录时返回空视图
+  CFGFileNode GetRootNode() const {
+    return mRootPath.empty() ? CFGFileNode() : CFGFileNode(&mTree, CFGFileTree::kRoot);
+  }
 
-  CFGFileParser::CFGFileParserPtr GetParser(const std::string &moduleName,
-                                            const std::string &fileName) const {
+  /**
+   * @brief 把(模块, 文件)驻留为句柄，同一对名字总得到同一个句柄
+   * 只在首次解析时拼接路径；模块未注册解析器时抛异常。文件是否存在在首次加载时检查
+   */
+  ParserHandle ResolveParser(const std::string &moduleName, const std::string &fileName) {
     EnsureRootPathSet();
-    std::string fullPath = mRootPath + "/" + moduleName + "/" + fileName;
-    std::cout << "[FullPath]: " << fullPath << std::endl;
-    if (!std::filesystem::exists(fullPath)) {
+    if (mParserCreators.find(moduleName) == mParserCreators.end()) {
+      throw CFGFileNodeException("No parser registered for module: " + moduleName);
+    }
+    std::lock_guard<std::mutex> lock(mParserMutex);
+    return ResolveLocked(moduleName, fileName);
+  }
+
+  /**
+   * @brief 按句柄取解析器：命中时不加锁，只原子读取槽位中的解析器并记下使用时刻，不访问文件系统也不输出日志
+   * 未驻留时在首次调用时创建并解析。设置了内存预算时，按需加载后淘汰最久未使用、
+   * 未固定且没有未保存行的解析器；被淘汰的解析器仍由持有者的shared_ptr保活，下次调用重新解析
+   */
+  CFGFileParser::CFGFileParserPtr GetParser(ParserHandle handle) {
+    if (auto *slot = FindSlot(handle)) {
+      if (auto parser = slot->parser.load(std::memory_order_acquire)) {
+        TouchSlot(*slot);
+        return parser;
+      }
+    }
+    std::string moduleName, fileName, fullPath;
+    {
+      std::lock_guard<std::mutex> lock(mParserMutex);
+      EnsureRootPathSet();
+      auto &slot = SlotLocked(handle);
+      if (auto parser = slot.parser.load(std::memory_order_relaxed)) {
+        TouchSlot(slot);
+        return parser;
+      }
+      moduleName = slot.moduleName;
+      fileName = slot.fileName;
+      fullPath = slot.fullPath;
+    }
+    if (!FileExists(moduleName, fileName, fullPath)) {
       throw CFGFileNodeException("File not found: " + fullPath);
     }
-    auto hit = mCFGParsers.find(fullPath);
-    if (hit == mCFGParsers.end()) {
-      throw CFGFileNodeException("Parser not found for file: " + fullPath);
+    // 解析在锁外进行，不阻塞其他文件的查找；并发加载同一文件时保留先登记的结果
+    CFGFileLoadStat stat;
+    stat.path = fullPath;
+    CFGFileParser::CFGFileParserPtr parser;
+    try {
+      parser = LoadParser(moduleName, fileName, stat);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mParserMutex);
+      RecordLoadLocked(stat);
+      throw;
     }
-    return hit->second;
+    const size_t bytes = parser->MemoryBytes();
+    std::lock_guard<std::mutex> lock(mParserMutex);
+    RecordLoadLocked(stat);
+    ++mCacheStats.misses;
+    auto stored = InstallParserLocked(handle, std::move(parser), bytes);
+    AddFileNodeLocked(moduleName, fileName, fullPath);
+    EnforceBudgetLocked(handle);
+    return stored;
+  }
+  // 已驻留过的(模块, 文件)直接在无锁索引中查到句柄，不拼接字符串也不加锁
+  CFGFileParser::CFGFileParserPtr GetParser(const std::string &moduleName, const std::string &fileName) {
+    if (const auto *slot = FindSlot(moduleName, fileName))
+      return GetParser(slot->handle);
+    return GetParser(ResolveParser(moduleName, fileName));
+  }
+
+  /**
+   * @brief 启用解析快照：各文件的.csvbin快照写到cache_dir，源文件未变化时下次启动直接加载
+   * 默认不写快照，配置目录可以是只读或共享的；传空字符串关闭。对之后创建的解析器生效
+   */
+  void SetBinaryCacheDir(const std::string &cache_dir) {
+    std::lock_guard<std::mutex> lock(mParserMutex);
+    mCacheDir = cache_dir;
+  }
+
+  // 内存预算（字节），0表示不限；超出时立即淘汰
+  void SetMemoryBudget(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mParserMutex);
+    mCacheStats.budgetBytes = bytes;
+    EnforceBudgetLocked(kInvalidParserHandle);
+  }
+  // 固定的文件（如HW映射表）始终常驻，不参与淘汰；可在加载前设置
+  void PinParser(const std::string &moduleName, const std::string &fileName) {
+    auto handle = ResolveParser(moduleName, fileName);
+    std::lock_guard<std::mutex> lock(mParserMutex);
+    mSlots[handle]->pinned = true;
+  }
+  void UnpinParser(const std::string &moduleName, const std::string &fileName) {
+    auto handle = ResolveParser(moduleName, fileName);
+    std::lock_guard<std::mutex> lock(mParserMutex);
+    mSlots[handle]->pinned = false;
+    EnforceBudgetLocked(kInvalidParserHandle);
+  }
+  /**
+   * @brief 监视mRootPath下CSV的新增、修改与删除，在后台重新解析并原子替换解析器表中的解析器
+   * 只重新解析当前驻留的解析器，未加载或已淘汰的文件在下次GetParser时按新内容加载；
+   * 持有旧CFGFileParserPtr的策略继续使用旧数据，不受影响。解析失败时保留旧解析器
+   * @param settle 同一批变更的静默时间，拷贝多个文件时合并为一次处理
+   */
+  void StartWatching(std::chrono::milliseconds settle = std::chrono::milliseconds(100)) {
+    EnsureRootPathSet();
+    if (mBundle) {
+      throw CFGFileNodeException("Cannot watch a config bundle: " + mRootPath);
+    }
+    mWatchSettle = settle;
+    mWatcher.Start(
+        mRootPath, [this](const std::vector<CFGFileWatcher::FileChange> &changes) { ApplyFileChanges(changes); },
+        settle);
+  }
+  void StopWatching() { mWatcher.Stop(); }
+  bool IsWatching() const { return mWatcher.IsRunning(); }
+
+  CFGCacheStats GetCacheStats() const {
+    std::lock_guard<std::mutex> lock(mParserMutex);
+    auto stats = mCacheStats;
+    for (const auto &slot : mSlots)
+      stats.hits += slot->hits.load(std::memory_order_relaxed);
+    stats.residentParsers = mResidentParsers;
+    stats.residentBytes = mResidentBytes;
+    return stats;
   }
 
   ParserCreator GetParserCreator(const std::string &moduleName) const {
@@ -105,14 +271,92 @@ public:
     return it->second;
   }
 
-  void LoadAllCFGFiles() {
+  /**
+   * @brief 并行加载全部配置：先枚举目录树，再按文件从大到小在线程池上创建并解析，
+   *        全部成功后一次性写入节点树与解析器表；任一文件失败则不提交任何结果并抛出异常
+   * @return 加载报告：每个文件的大小、行列数、分阶段耗时与内存峰值，按调度顺序（文件从大到小）排列
+   */
+  CFGLoadReport LoadAllCFGFiles(const std::shared_ptr<ThreadPool> &pool = ThreadPool::Shared()) {
     EnsureRootPathSet();
-    TraverseAndLoadFiles(mRootPath);
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::string> dirNames;
+    std::vector<PendingFile> files;
+    if (mBundle)
+      EnumerateBundle(dirNames, files);
+    else
+      EnumerateFiles(mRootPath, mRootPath, dirNames, files);
+    // 大文件先调度，避免最后只剩一个大文件拖尾
+    std::stable_sort(files.begin(), files.end(),
+                     [](const PendingFile &a, const PendingFile &b) { return a.stat.bytes > b.stat.bytes; });
+
+    std::atomic<size_t> next(0);
+    auto worker = [this, &files, &next](size_t) {
+      for (size_t i = next.fetch_add(1); i < files.size(); i = next.fetch_add(1))
+        ParsePendingFile(files[i]);
+    };
+    if (pool && files.size() > 1)
+      pool->ParallelFor(std::min(files.size(), pool->Size() + 1), worker);
+    else
+      worker(0);
+
+    CFGLoadReport report;
+    std::string errors;
+    for (auto &file : files) {
+      if (!file.stat.error.empty())
+        errors += "\n  " + file.stat.path + ": " + file.stat.error;
+      report.files.push_back(file.stat);
+    }
+    if (errors.empty())
+      CommitLoadedFiles(dirNames, files);
+    report.wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    {
+      std::lock_guard<std::mutex> lock(mParserMutex);
+      mLoadReport = report;
+    }
+    if (!errors.empty())
+      throw CFGFileNodeException("Failed to load config files:" + errors);
+    return report;
+  }
+  // 最近一次LoadAllCFGFiles的逐文件记录，加上之后LoadCFGFile与按需加载的文件；加载失败的文件也在其中
+  CFGLoadReport GetLoadReport() const {
+    std::lock_guard<std::mutex> lock(mParserMutex);
+    return mLoadReport;
+  }
+
+  /**
+   * @brief 把root_path/Configs下的全部CSV按各模块的解析器解析后打成一个配置包
+   * 包内保存源内容与解析快照，部署后SetRootPath(bundle_path)即可加载；任一文件解析失败时抛异常且不生成包
+   */
+  void WriteBundle(const std::string &root_path, const std::string &bundle_path) const {
+    const auto configRoot = std::filesystem::absolute(NormalizePath(root_path)).string() + "/Configs";
+    if (!std::filesystem::is_directory(configRoot)) {
+      throw CFGFileNodeException("Config directory does not exist: " + configRoot);
+    }
+    std::vector<std::string> dirNames;
+    std::vector<PendingFile> files;
+    EnumerateFiles(configRoot, configRoot, dirNames, files);
+    std::vector<CFGBundle::Source> sources(files.size());
+    for (size_t i = 0; i < files.size(); ++i) {
+      sources[i].moduleName = files[i].moduleName;
+      sources[i].fileName = files[i].fileName;
+      auto parser = GetParserCreator(files[i].moduleName)(files[i].stat.path);
+      if (!parser->ExportImage(sources[i].content, sources[i].image)) {
+        throw CFGFileNodeException("Cannot export table image for: " + files[i].stat.path);
+      }
+    }
+    std::sort(sources.begin(), sources.end(), [](const auto &a, const auto &b) {
+      return std::tie(a.moduleName, a.fileName) < std::tie(b.moduleName, b.fileName);
+    });
+    CFGBundle::Write(bundle_path, sources);
   }
 
+  // 释放全部解析器与节点树；已驻留的句柄与固定标记保留
   void Clear() {
-    mCFGParsers.clear();
-    mRootNode.reset();
+    std::lock_guard<std::mutex> lock(mParserMutex);
+    for (auto &slot : mSlots)
+      DropParserLocked(*slot);
+    mBundle.reset();
+    mTree.Reset({});
     mRootPath.clear();
   }
 
@@ -121,6 +365,34 @@ public:
   }
 
 private:
+  /**
+   * @brief 每个驻留过的(模块, 文件)一项，句柄即其序号，只增不删，地址在管理器存续期间不变
+   * 名字与句柄创建后不变；parser、lastUse与hits可无锁读写，其余字段受mParserMutex保护
+   */
+  struct ParserSlot {
+    std::string moduleName;
+    std::string fileName;
+    size_t hash = 0;
+    ParserHandle handle = kInvalidParserHandle;
+    std::atomic<CFGFileParser::CFGFileParserPtr> parser; // 为空表示未加载或已被淘汰
+    std::atomic<uint64_t> lastUse{0};                    // 最近一次使用时的mUseTick，淘汰时取最小者
+    std::atomic<uint64_t> hits{0};
+    std::string fullPath;
+    size_t bytes = 0; // 登记时计入mResidentBytes的占用
+    bool pinned = false;
+  };
+  /**
+   * @brief 供无锁读取的槽位索引：按句柄的数组与按(模块, 文件)的开放寻址散列表（负载不超过1/2）
+   * 写者持mParserMutex只追加，先写槽位再以release发布count；容量不足时按两倍重建并发布新索引，
+   * 旧索引保留到管理器析构（总量不超过最新索引的两倍），读者不需要引用计数
+   */
+  struct SlotIndex {
+    explicit SlotIndex(size_t capacity) : slots(capacity), buckets(capacity * 2) {}
+    std::vector<std::atomic<ParserSlot *>> slots;   // 下标即句柄
+    std::vector<std::atomic<ParserSlot *>> buckets; // 大小为2的幂
+    std::atomic<size_t> count{0};
+  };
+
   CFGFileManager() {
     RegisterModuleParser("FE", [](const std::string &cfg) { return CreateParser<RX::FE>(cfg); });
     RegisterModuleParser("REC", [](const std::string &cfg) { return CreateParser<RX::REC>(cfg); });
@@ -128,10 +400,11 @@ private:
   }
 
   ~CFGFileManager() {
+    StopWatching();
     Clear();
     mParserCreators.clear();
   }
-  std::string NormalizePath(const std::string &rawPath) {
+  std::string NormalizePath(const std::string &rawPath) const {
     std::filesystem::path path(rawPath);
     path = std::filesystem::weakly_canonical(path);
     return path.generic_string();
@@ -141,18 +414,316 @@ private:
     mParserCreators[moduleName] = std::move(parser);
   }
 
-  void TraverseAndLoadFiles(const std::string &currentPath) {
+  // 枚举阶段发现的文件，解析结果在提交前只存放在这里
+  struct PendingFile {
+    std::string moduleName;
+    std::string fileName;
+    CFGFileLoadStat stat;
+    CFGFileParser::CFGFileParserPtr parser;
+    size_t bytes = 0; // 解析后的内存占用，在工作线程上测得
+  };
+
+  void EnumerateFiles(const std::string &configRoot, const std::string &currentPath, std::vector<std::string> &dirNames,
+                      std::vector<PendingFile> &files) const {
     for (const auto &entry : std::filesystem::directory_iterator(currentPath)) {
       if (entry.is_directory()) {
-        auto dirName = entry.path().filename().string();
-        auto dirNode = CFGFileNode::Create(dirName);
-        mRootNode->AddChild(dirName, dirNode);
-        TraverseAndLoadFiles(entry.path().generic_string());
-      } else if (entry.is_regular_file()) {
-        auto fileName = entry.path().filename().string();
-        auto moduleName = entry.path().parent_path().filename().string();
-        LoadCFGFile(moduleName, fileName);
+        dirNames.push_back(entry.path().filename().string());
+        EnumerateFiles(configRoot, entry.path().generic_string(), dirNames, files);
+      } else if (entry.is_regular_file() && entry.path().extension() == ".csv") {
+        // 只加载CSV，跳过同目录下的.csvbin快照等文件
+        PendingFile file;
+        file.moduleName = entry.path().parent_path().filename().string();
+        file.fileName = entry.path().filename().string();
+        file.stat.path = configRoot + "/" + file.moduleName + "/" + file.fileName;
+        file.stat.bytes = entry.file_size();
+        files.push_back(std::move(file));
+      }
+    }
+  }
+
+  // 配置包的目录表即文件列表，不访问文件系统
+  void EnumerateBundle(std::vector<std::string> &dirNames, std::vector<PendingFile> &files) const {
+    for (const auto &entry : mBundle->Entries()) {
+      PendingFile file;
+      file.moduleName = entry.moduleName;
+      file.fileName = entry.fileName;
+      file.stat.path = MakeFullPath(file.moduleName, file.fileName);
+      file.stat.bytes = entry.content.size();
+      if (std::find(dirNames.begin(), dirNames.end(), file.moduleName) == dirNames.end())
+        dirNames.push_back(file.moduleName);
+      files.push_back(std::move(file));
+    }
+  }
+
+  bool FileExists(const std::string &moduleName, const std::string &fileName, const std::string &fullPath) const {
+    return mBundle ? mBundle->Find(moduleName, fileName) != nullptr : std::filesystem::exists(fullPath);
+  }
+  // 创建（尚未解析的）解析器；配置包模式下解析器从包内映像加载
+  CFGFileParser::CFGFileParserPtr CreateParserFor(const std::string &moduleName, const std::string &fileName,
+                                                  const std::string &fullPath) const {
+    auto parser = GetParserCreator(moduleName)(fullPath);
+    std::string cacheDir;
+    {
+      std::lock_guard<std::mutex> lock(mParserMutex);
+      cacheDir = mCacheDir;
+    }
+    if (!cacheDir.empty())
+      parser->SetBinaryCacheDir(cacheDir);
+    if (mBundle) {
+      const auto *entry = mBundle->Find(moduleName, fileName);
+      if (!entry) {
+        throw CFGFileNodeException("File not found in bundle: " + fullPath);
+      }
+      parser->SetImageSource(mBundle->Image(*entry));
+    }
+    return parser;
+  }
+
+  // 在工作线程上执行：只写入file自身，不触碰共享状态；失败原因记在file.stat.error
+  void ParsePendingFile(PendingFile &file) const {
+    try {
+      file.parser = LoadParser(file.moduleName, file.fileName, file.stat);
+      file.bytes = file.parser->MemoryBytes();
+    } catch (const std::exception &) {
+      file.parser.reset();
+    }
+  }
+
+  // 创建并解析stat.path对应的解析器，把总耗时与解析器的分阶段记录填入stat；失败时记下原因并重新抛出
+  CFGFileParser::CFGFileParserPtr LoadParser(const std::string &moduleName, const std::string &fileName,
+                                             CFGFileLoadStat &stat) const {
+    const auto start = std::chrono::steady_clock::now();
+    auto elapsedMs = [&start] {
+      return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+    try {
+      auto parser = CreateParserFor(moduleName, fileName, stat.path);
+      parser->parse();
+      const auto profile = parser->GetParseProfile();
+      stat.bytes = profile.bytes;
+      stat.rows = profile.rows;
+      stat.cells = profile.cells;
+      stat.ioMs = profile.io_ms;
+      stat.splitMs = profile.split_ms;
+      stat.validateMs = profile.validate_ms;
+      stat.estimatedPeakBytes = profile.estimated_peak_bytes;
+      stat.source = profile.source;
+      stat.error.clear();
+      stat.parseMs = elapsedMs();
+      return parser;
+    } catch (const std::exception &ex) {
+      stat.error = ex.what();
+      stat.parseMs = elapsedMs();
+      throw;
+    }
+  }
+  // 同一路径只保留最近一次加载的记录
+  void RecordLoadLocked(const CFGFileLoadStat &stat) {
+    auto it = std::find_if(mLoadReport.files.begin(), mLoadReport.files.end(),
+                           [&stat](const CFGFileLoadStat &file) { return file.path == stat.path; });
+    if (it != mLoadReport.files.end())
+      *it = stat;
+    else
+      mLoadReport.files.push_back(stat);
+  }
+
+  // 单一提交步骤：在调用线程上一次性建立节点树并登记解析器
+  void CommitLoadedFiles(const std::vector<std::string> &dirNames, std::vector<PendingFile> &files) {
+    std::lock_guard<std::mutex> lock(mParserMutex);
+    for (const auto &dirName : dirNames) {
+      mTree.AddDirectory(CFGFileTree::kRoot, dirName);
+    }
+    for (auto &file : files) {
+      AddFileNodeLocked(file.moduleName, file.fileName, file.stat.path);
+      InstallParserLocked(ResolveLocked(file.moduleName, file.fileName), std::move(file.parser), file.bytes);
+    }
+    EnforceBudgetLocked(kInvalidParserHandle);
+  }
+
+  void AddFileNodeLocked(const std::string &moduleName, const std::string &fileName, const std::string &fullPath) {
+    auto moduleNode = mTree.AddDirectory(CFGFileTree::kRoot, moduleName);
+    if (moduleNode == CFGFileTree::kNoNode || mTree.AddFile(moduleNode, fileName, fullPath) == CFGFileTree::kNoNode)
+      throw CFGFileNodeException("Cannot add config file node: " + moduleName + "/" + fileName);
+  }
+
+  std::string MakeFullPath(const std::string &moduleName, const std::string &fileName) const {
+    return mRootPath + "/" + moduleName + "/" + fileName;
+  }
+
+  static size_t SlotHash(std::string_view moduleName, std::string_view fileName) {
+    const size_t hash = std::hash<std::string_view>{}(moduleName);
+    return hash ^ (std::hash<std::string_view>{}(fileName) + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2));
+  }
+  // 无锁查找，持锁时也可调用；未驻留过时返回空
+  ParserSlot *FindSlot(std::string_view moduleName, std::string_view fileName) const {
+    const auto *index = mSlotIndex.load(std::memory_order_acquire);
+    if (!index)
+      return nullptr;
+    const size_t hash = SlotHash(moduleName, fileName);
+    const size_t mask = index->buckets.size() - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+      auto *slot = index->buckets[i].load(std::memory_order_acquire);
+      if (!slot || (slot->hash == hash && slot->moduleName == moduleName && slot->fileName == fileName))
+        return slot;
+    }
+  }
+  ParserSlot *FindSlot(ParserHandle handle) const {
+    const auto *index = mSlotIndex.load(std::memory_order_acquire);
+    if (!index || handle >= index->count.load(std::memory_order_acquire))
+      return nullptr;
+    return index->slots[handle].load(std::memory_order_acquire);
+  }
+  // 命中时取一个新的使用时刻，每次命中的时刻互不相同，淘汰顺序与实际使用顺序一致
+  void TouchSlot(ParserSlot &slot) const {
+    slot.hits.fetch_add(1, std::memory_order_relaxed);
+    slot.lastUse.store(NextUseTick(), std::memory_order_relaxed);
+  }
+  uint64_t NextUseTick() const { return mUseTick.fetch_add(1, std::memory_order_relaxed) + 1; }
+
+  ParserHandle ResolveLocked(const std::string &moduleName, const std::string &fileName) {
+    if (const auto *slot = FindSlot(moduleName, fileName))
+      return slot->handle;
+    const size_t count = mSlots.size();
+    if (count >= kInvalidParserHandle) {
+      throw CFGFileNodeException("Too many config files: " + moduleName + "/" + fileName);
+    }
+    auto slot = std::make_unique<ParserSlot>();
+    slot->moduleName = moduleName;
+    slot->fileName = fileName;
+    slot->hash = SlotHash(moduleName, fileName);
+    slot->handle = static_cast<ParserHandle>(count);
+    slot->fullPath = MakeFullPath(moduleName, fileName);
+    auto *index = mSlotIndex.load(std::memory_order_relaxed);
+    if (!index || count == index->slots.size())
+      index = GrowSlotIndexLocked();
+    IndexSlot(*index, slot.get());
+    index->count.store(count + 1, std::memory_order_release);
+    mSlots.push_back(std::move(slot));
+    return static_cast<ParserHandle>(count);
+  }
+  // 按两倍容量重建索引并发布，旧索引留在mSlotIndexes中，仍在读取它的线程不受影响
+  SlotIndex *GrowSlotIndexLocked() {
+    auto index = std::make_unique<SlotIndex>(std::max<size_t>(64, mSlots.size() * 2));
+    for (const auto &slot : mSlots)
+      IndexSlot(*index, slot.get());
+    index->count.store(mSlots.size(), std::memory_order_relaxed);
+    auto *published = index.get();
+    mSlotIndexes.push_back(std::move(index));
+    mSlotIndex.store(published, std::memory_order_release);
+    return published;
+  }
+  static void IndexSlot(SlotIndex &index, ParserSlot *slot) {
+    index.slots[slot->handle].store(slot, std::memory_order_release);
+    const size_t mask = index.buckets.size() - 1;
+    size_t i = slot->hash & mask;
+    while (index.buckets[i].load(std::memory_order_relaxed))
+      i = (i + 1) & mask;
+    index.buckets[i].store(slot, std::memory_order_release);
+  }
+  ParserHandle FindLocked(const std::string &moduleName, const std::string &fileName) const {
+    const auto *slot = FindSlot(moduleName, fileName);
+    return slot ? slot->handle : kInvalidParserHandle;
+  }
+  ParserSlot &SlotLocked(ParserHandle handle) {
+    if (handle >= mSlots.size()) {
+      throw CFGFileNodeException("Invalid parser handle: " + std::to_string(handle));
+    }
+    return *mSlots[handle];
+  }
+
+  /**
+   * @brief 登记解析器并置为最近使用；已驻留时保留原解析器并返回它
+   * @param bytes 解析器的内存占用，由调用者在锁外测得，计入常驻字节数
+   */
+  CFGFileParser::CFGFileParserPtr InstallParserLocked(ParserHandle handle, CFGFileParser::CFGFileParserPtr parser,
+                                                      size_t bytes) {
+    auto &slot = *mSlots[handle];
+    slot.lastUse.store(NextUseTick(), std::memory_order_relaxed);
+    if (auto existing = slot.parser.load(std::memory_order_relaxed))
+      return existing;
+    slot.parser.store(parser, std::memory_order_release);
+    slot.bytes = bytes;
+    mResidentBytes += bytes;
+    ++mResidentParsers;
+    return parser;
+  }
+  void DropParserLocked(ParserSlot &slot) {
+    if (!slot.parser.load(std::memory_order_relaxed))
+      return;
+    slot.parser.store(nullptr, std::memory_order_release);
+    mResidentBytes -= slot.bytes;
+    slot.bytes = 0;
+    --mResidentParsers;
+  }
+
+  // 按最近使用时刻从旧到新淘汰，直到不超过预算；keep为刚加载的文件，不淘汰。未超预算时不遍历
+  void EnforceBudgetLocked(ParserHandle keep) {
+    if (mCacheStats.budgetBytes == 0 || mResidentBytes <= mCacheStats.budgetBytes)
+      return;
+    std::vector<std::pair<uint64_t, ParserSlot *>> candidates;
+    for (const auto &slot : mSlots) {
+      if (slot->handle != keep && !slot->pinned && slot->parser.load(std::memory_order_relaxed))
+        candidates.emplace_back(slot->lastUse.load(std::memory_order_relaxed), slot.get());
+    }
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [](const auto &a, const auto &b) { return a.first < b.first; });
+    for (auto [lastUse, slot] : candidates) {
+      if (mResidentBytes <= mCacheStats.budgetBytes)
+        break;
+      if (slot->parser.load(std::memory_order_relaxed)->HasUnsavedRows())
+        continue;
+      DropParserLocked(*slot);
+      ++mCacheStats.evictions;
+    }
+  }
+
+  // 在监视线程上执行：解析在锁外进行，替换解析器与更新节点树在锁内完成
+  void ApplyFileChanges(const std::vector<CFGFileWatcher::FileChange> &changes) {
+    for (const auto &change : changes) {
+      const auto moduleName = std::filesystem::path(change.dir).filename().string();
+      const auto fullPath = mRootPath + "/" + moduleName + "/" + change.fileName;
+      if (change.kind == CFGFileWatcher::ChangeKind::Removed) {
+        std::lock_guard<std::mutex> lock(mParserMutex);
+        auto handle = FindLocked(moduleName, change.fileName);
+        if (handle != kInvalidParserHandle)
+          DropParserLocked(*mSlots[handle]);
+        mTree.Remove(mTree.FindPath(moduleName, change.fileName));
+        continue;
+      }
+      if (mParserCreators.find(moduleName) == mParserCreators.end())
+        continue;
+      ParserHandle handle;
+      {
+        std::lock_guard<std::mutex> lock(mParserMutex);
+        AddFileNodeLocked(moduleName, change.fileName, fullPath);
+        handle = FindLocked(moduleName, change.fileName);
+        if (handle == kInvalidParserHandle || !mSlots[handle]->parser.load(std::memory_order_relaxed))
+          continue;
+      }
+      CFGFileParser::CFGFileParserPtr parser;
+      size_t bytes = 0;
+      try {
+        parser = CreateParserFor(moduleName, change.fileName, fullPath);
+        parser->parse();
+        bytes = parser->MemoryBytes();
+      } catch (const std::exception &ex) {
+        std::cerr << "[CFGFileManager] Reload failed, keeping previous data for " << fullPath << ": " << ex.what()
+                  << std::endl;
+        continue;
       }
+      std::lock_guard<std::mutex> lock(mParserMutex);
+      auto &slot = *mSlots[handle];
+      auto previous = slot.parser.load(std::memory_order_relaxed);
+      if (!previous)
+        continue; // 解析期间已被淘汰或删除
+      // 文件是校准数据的权威来源，基于旧数据拟合且未保存的行随旧解析器一起丢弃
+      if (previous->HasUnsavedRows())
+        std::cerr << "[CFGFileManager] Discarding unsaved fitted rows of reloaded file " << fullPath << std::endl;
+      slot.parser.store(std::move(parser), std::memory_order_release);
+      mResidentBytes += bytes - slot.bytes;
+      slot.bytes = bytes;
+      ++mCacheStats.reloads;
+      EnforceBudgetLocked(handle);
     }
   }
 
@@ -163,9 +734,23 @@ private:
   }
 
   std::string mRootPath;
-  CFGFileNode::FileNodePtr mRootNode;
+  std::shared_ptr<const CFGBundle> mBundle; // 为空表示从目录加载
+  CFGFileTree mTree; // 节点树，受mParserMutex保护
   std::unordered_map<std::string, ParserCreator> mParserCreators;
-  std::unordered_map<std::string, CFGFileParser::CFGFileParserPtr> mCFGParsers;
+  // 以下解析器缓存状态均受mParserMutex保护
+  mutable std::mutex mParserMutex;
+  std::vector<std::unique_ptr<ParserSlot>> mSlots; // 下标即句柄
+  std::vector<std::unique_ptr<SlotIndex>> mSlotIndexes; // 发布过的全部索引，最后一个为当前索引
+  std::atomic<SlotIndex *> mSlotIndex{nullptr};          // 读者无锁读取，只在持锁扩容时替换
+  // 每次登记或命中解析器时递增；独占一个缓存行，命中时的写入不影响读者读取mSlotIndex
+  alignas(64) mutable std::atomic<uint64_t> mUseTick{0};
+  size_t mResidentParsers = 0;
+  size_t mResidentBytes = 0; // 各驻留解析器登记时占用之和，随登记、淘汰与重新加载增减
+  CFGCacheStats mCacheStats;
+  CFGLoadReport mLoadReport;
+  std::string mCacheDir; // 为空表示不写.csvbin快照
+  std::chrono::milliseconds mWatchSettle{100}; // 最近一次StartWatching的settle，SetRootPath恢复监视时沿用
+  CFGFileWatcher mWatcher; // 最后声明，析构时最先停止，回调不会访问已销毁的成员
 };
 
 #endif // CFGFILEMANAGER_HPP
\ No newline at end of file
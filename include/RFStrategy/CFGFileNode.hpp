@@ -1,11 +1,11 @@
 #ifndef CONFIG_FILE_NODE_HPP
 #define CONFIG_FILE_NODE_HPP
 
-#include <iostream>
-#include <memory>
-#include <string>
-#include <unordered_map>
+#include <iterator>
+#include <string_view>
+#include <utility>
 
+#include "../CFGFileTree.hpp"
 #include "CFGFileParser.hpp"
 
 class CFGFileNodeException : public std::runtime_error {
@@ -13,45 +13,78 @@ public:
   explicit CFGFileNodeException(const std::string &details) : std::runtime_error("CFGFileNodeException: " + details) {}
 };
 
-class CFGFileNode : public std::enable_shared_from_this<CFGFileNode> {
+/**
+ * @brief CFGFileTree中一个节点的视图（树指针 + 下标），按值传递，不持有节点
+ * 保留原先的GetChild/GetChildren接口；找不到的节点是空视图，转换为false。
+ * 视图不延长树的生命周期，树被修改后旧视图可能指向已删除或复用的槽位
+ */
+class CFGFileNode {
 public:
-  typedef std::shared_ptr<CFGFileNode> FileNodePtr;
-  typedef std::weak_ptr<CFGFileNode> FileNodeWeakPtr;
-  typedef std::unordered_map<std::string, FileNodePtr> FileNodeMap;
+  using NodeIndex = CFGFileTree::NodeIndex;
+  typedef CFGFileNode FileNodePtr; // 兼容旧代码的 node->GetChild(...) 写法
 
-  static FileNodePtr Create(const std::string &node_name, const std::string &file_name = "") {
-    return FileNodePtr(new CFGFileNode(node_name, file_name));
-  }
-  void AddChild(const std::string &childName, const FileNodePtr &childNode) {
-    if (isFile()) {
-      throw CFGFileNodeException("Cannot add child to a file node");
+  // 按插入顺序遍历子节点，元素为(名字, 视图)
+  class ChildIterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::pair<std::string_view, CFGFileNode>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = value_type;
+
+    ChildIterator(const CFGFileTree *tree, NodeIndex index) : m_tree(tree), m_index(index) {}
+    value_type operator*() const { return {m_tree->Name(m_index), CFGFileNode(m_tree, m_index)}; }
+    ChildIterator &operator++() {
+      m_index = m_tree->NextSibling(m_index);
+      return *this;
+    }
+    ChildIterator operator++(int) {
+      auto old = *this;
+      ++*this;
+      return old;
     }
-    if (!childNode)
-      throw CFGFileNodeException("Child node is null");
+    bool operator==(const ChildIterator &other) const { return m_index == other.m_index; }
+    bool operator!=(const ChildIterator &other) const { return m_index != other.m_index; }
 
-    childNode->m_parent = shared_from_this();
-    m_children[childName] = childNode;
-  }
-  FileNodePtr GetChild(const std::string &childName) {
-    auto it = m_children.find(childName);
-    return it != m_children.end() ? it->second : nullptr;
+  private:
+    const CFGFileTree *m_tree;
+    NodeIndex m_index;
+  };
+  class FileNodeMap {
+  public:
+    FileNodeMap(const CFGFileTree *tree, NodeIndex parent) : m_tree(tree), m_parent(parent) {}
+    ChildIterator begin() const {
+      return {m_tree, m_tree ? m_tree->FirstChild(m_parent) : CFGFileTree::kNoNode};
+    }
+    ChildIterator end() const { return {m_tree, CFGFileTree::kNoNode}; }
+    size_t size() const { return m_tree ? m_tree->ChildCount(m_parent) : 0; }
+    bool empty() const { return size() == 0; }
+
+  private:
+    const CFGFileTree *m_tree;
+    NodeIndex m_parent;
+  };
+
+  CFGFileNode() = default;
+  CFGFileNode(const CFGFileTree *tree, NodeIndex index) : m_tree(tree), m_index(index) {}
+
+  explicit operator bool() const { return m_tree && m_tree->IsValid(m_index); }
+  const CFGFileNode *operator->() const { return this; }
+
+  CFGFileNode GetChild(std::string_view childName) const {
+    return *this ? CFGFileNode(m_tree, m_tree->Find(m_index, childName)) : CFGFileNode();
   }
-  FileNodePtr GetParent() { return m_parent.lock(); }
-  const std::string &GetNodeName() const { return m_node_name; }
-  const std::string &GetFilePath() const { return m_file_name; }
-  bool isFile() const { return !m_file_name.empty(); }
-  bool isDirectory() const { return !isFile(); }
-  const FileNodeMap &GetChildren() const { return m_children; }
+  CFGFileNode GetParent() const { return *this ? CFGFileNode(m_tree, m_tree->Parent(m_index)) : CFGFileNode(); }
+  std::string_view GetNodeName() const { return *this ? m_tree->Name(m_index) : std::string_view(); }
+  std::string_view GetFilePath() const { return *this ? m_tree->FilePath(m_index) : std::string_view(); }
+  bool isFile() const { return *this && m_tree->IsFile(m_index); }
+  bool isDirectory() const { return *this && !m_tree->IsFile(m_index); }
+  FileNodeMap GetChildren() const { return *this ? FileNodeMap(m_tree, m_index) : FileNodeMap(nullptr, 0); }
+  NodeIndex GetIndex() const { return m_index; }
 
 private:
-  explicit CFGFileNode(const std::string &node_name, const std::string &file_name = "")
-      : m_node_name(node_name), m_file_name(file_name) {
-    std::cout << "Node name: " << m_node_name << std::endl;
-  }
-  std::string m_node_name;
-  std::string m_file_name;
-  FileNodeWeakPtr m_parent;
-  FileNodeMap m_children;
+  const CFGFileTree *m_tree = nullptr;
+  NodeIndex m_index = CFGFileTree::kNoNode;
 };
 
-#endif // CONFIG_FILE_NODE_HPP
\ No newline at end of file
+#endif // CONFIG_FILE_NODE_HPP
@@ -12,85 +12,262 @@
 #define __MODULEPARSER_HPP__
 
 #include "../CSVReader.h"
+#include "../CSVSchema.hpp"
+#include "../CSVVersionedTable.hpp"
+#include "FreqPowerIndex.hpp"
 #include <any>
+#include <atomic>
+#include <filesystem>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <string_view>
 #include <vector>
 
+// 配置包中一张表的快照映像：content为源CSV内容，image为.csvbin格式映像，二者都位于mapping中
+struct CFGTableImage {
+  std::shared_ptr<const MemoryMap> mapping;
+  std::string_view content;
+  std::string_view image;
+};
+
 // Base class for all module parsers
 class CFGFileParser {
 public:
   using CFGFileParserPtr = std::shared_ptr<CFGFileParser>;
+  using TableSnapshot = VersionedTable::Snapshot;
+  using VersionedSnapshot = VersionedTable::VersionedSnapshot;
+  // 源文件标识：大小与修改时间，与.csvbin快照判断源文件是否变化的依据相同
+  struct SourceStamp {
+    uint64_t size = 0;
+    int64_t mtime = 0;
+    bool operator==(const SourceStamp &) const = default;
+  };
+
   virtual ~CFGFileParser() = default;
-  virtual void parse() = 0;
-  virtual CSVParser::DataContainer GetModuleCFGData() const = 0;
+  // 只在首次调用时读取并解析，之后直接返回（O(1)，不访问文件）；文件变更由CFGFileWatcher或Reparse重新加载
+  void parse() {
+    if (m_parsed.load(std::memory_order_acquire))
+      return;
+    std::lock_guard<std::mutex> lock(m_parse_mutex);
+    if (m_parsed.load(std::memory_order_relaxed))
+      return;
+    LoadLocked();
+  }
+  // 无条件重新读取并解析，持有旧快照的读者不受影响；失败时保留当前数据并抛异常
+  void Reparse() {
+    std::lock_guard<std::mutex> lock(m_parse_mutex);
+    LoadLocked();
+  }
+  bool IsParsed() const { return m_parsed.load(std::memory_order_acquire); }
+  // 内容版本：由载入内容的源文件标识与之后追加的拟合行数决定，内容未变（含重新解析未变化的文件）时不变
+  virtual uint64_t GetContentVersion() const = 0;
+  // 不可变快照，持有期间行视图始终有效，不受并发插入影响
+  virtual TableSnapshot GetSnapshot() const = 0;
+  // 快照连同其版本号，用于按版本取缓存的索引
+  virtual VersionedSnapshot GetVersionedSnapshot() const = 0;
+  /**
+   * @brief 与snapshot同一base的Freq/Power有序索引，首次调用时构建
+   * 追加拟合行后按新版本增量更新；返回的索引可能比snapshot新，查询时须以snapshot的行数截断
+   */
+  std::shared_ptr<const FreqPowerIndex> GetFreqPowerIndex(const VersionedSnapshot &snapshot) const {
+    // 快路径：已发布的索引覆盖该快照时无锁返回
+    auto index = m_freq_power_index.load(std::memory_order_acquire);
+    if (index && index->Base() == snapshot.base && index->Version() >= snapshot.number)
+      return index;
+    // 构建与增量更新串行进行，锁内重新读取，避免并发查询重复构建
+    std::lock_guard<std::mutex> lock(m_index_mutex);
+    index = m_freq_power_index.load(std::memory_order_acquire);
+    if (index && index->Base() == snapshot.base) {
+      if (index->Version() >= snapshot.number)
+        return index;
+      index = FreqPowerIndex::Extend(*index, *snapshot.table, snapshot.number);
+    } else {
+      const bool stale = index && index->Base() > snapshot.base;
+      index = FreqPowerIndex::Build(*snapshot.table, snapshot.number, snapshot.base);
+      if (stale)
+        return index; // 重新解析前取得的旧快照，不替换新内容的索引
+    }
+    m_freq_power_index.store(index, std::memory_order_release);
+    return index;
+  }
   virtual std::any OnQuery(QueryStrategyCallback query) = 0;
   virtual const std::vector<std::string_view> &GetColumnNames() const = 0;
   const std::string &GetModuleName() const { return m_moduleName; }
   // 新增行的接口。此处改为 AddFittedRow，支持单行或批量
   virtual bool AddFittedRows(const std::vector<std::vector<std::string>> &fittedRows) = 0;
+  // 把新增的拟合行追加写回配置文件
+  virtual void SaveFittedRows() = 0;
+  // 当前版本占用的内存估算（表结构 + 源缓冲区 + 追加行 + 查询索引），供CFGFileManager按内存预算淘汰
+  virtual size_t MemoryBytes() const = 0;
+  // 是否有尚未写回文件的拟合行；有则不能被淘汰，否则这些行会丢失
+  virtual bool HasUnsavedRows() const = 0;
+  // 设置后parse()从映像加载而不读文件，用于从配置包加载
+  virtual void SetImageSource(CFGTableImage image) = 0;
+  // 在parse()之前调用：启用.csvbin快照并存放到cache_dir；默认不写快照
+  virtual void SetBinaryCacheDir(const std::string &cache_dir) = 0;
+  // 解析源文件并导出内容与映像，供打包配置包
+  virtual bool ExportImage(std::string &content, std::string &image) const = 0;
+  // 最近一次成功解析的分阶段记录
+  virtual ParseProfile GetParseProfile() const = 0;
 
 protected:
   CFGFileParser(std::string moduleName) : m_moduleName(std::move(moduleName)) {}
+  // 实际的读取与解析，由parse/Reparse在m_parse_mutex下调用
+  virtual void ParseContent() = 0;
+  // 读取源文件当前的标识，只在（重新）加载时调用；源不可变（如配置包映像）或无法访问时返回false
+  virtual bool ReadSourceStamp(SourceStamp &stamp) const = 0;
+  // 当前数据载入时的源文件标识
+  SourceStamp LoadedSourceStamp() const {
+    return {m_source_size.load(std::memory_order_relaxed), m_source_mtime.load(std::memory_order_relaxed)};
+  }
+  size_t IndexBytes() const {
+    auto index = m_freq_power_index.load(std::memory_order_acquire);
+    return index ? index->MemoryBytes() : 0;
+  }
   std::string m_moduleName;
+
+private:
+  // 先取标识再读内容：读取期间发生的修改会让下一次Reparse得到不同的版本；失败时保留当前数据与标识
+  void LoadLocked() {
+    SourceStamp stamp;
+    if (!ReadSourceStamp(stamp))
+      stamp = {};
+    ParseContent();
+    m_source_size.store(stamp.size, std::memory_order_relaxed);
+    m_source_mtime.store(stamp.mtime, std::memory_order_relaxed);
+    m_parsed.store(true, std::memory_order_release);
+    std::lock_guard<std::mutex> indexLock(m_index_mutex);
+    m_freq_power_index.store(nullptr, std::memory_order_release); // 新内容的base不同，索引下次查询时重建
+  }
+
+  std::atomic<bool> m_parsed{false};
+  std::atomic<uint64_t> m_source_size{0}; // 与m_source_mtime一起构成LoadedSourceStamp
+  std::atomic<int64_t> m_source_mtime{0};
+  std::mutex m_parse_mutex;
+  mutable std::mutex m_index_mutex; // 串行化索引的构建与更新，读取不加锁
+  mutable std::atomic<std::shared_ptr<const FreqPowerIndex>> m_freq_power_index;
 };
 
 // Template for a generic parser
 template <typename Module> class GenericParser : public CFGFileParser {
 public:
   explicit GenericParser(const std::string &cfg, ParseMode mode = ParseMode::Synchronous)
-      : CFGFileParser(Module::ModuleName), m_cfg(cfg), m_parser(mode) {}
-  void parse() override { m_parser.ParseDataFromCSV(m_cfg); }
-  CSVParser::DataContainer GetModuleCFGData() const override { return m_parser.GetCSVData(); }
-  std::any OnQuery(QueryStrategyCallback query) override { return m_parser.OnQuery(query); }
+      : CFGFileParser(Module::ModuleName), m_cfg(cfg), m_parser(mode) {
+    Configure(m_parser);
+  }
+  uint64_t GetContentVersion() const override {
+    const auto stamp = LoadedSourceStamp();
+    const uint64_t parts[] = {stamp.size, static_cast<uint64_t>(stamp.mtime), m_versions.Acquire()->size()};
+    return CSVUtils::BinaryCache::HashBytes({reinterpret_cast<const char *>(parts), sizeof(parts)});
+  }
+
+protected:
+  bool ReadSourceStamp(SourceStamp &stamp) const override {
+    return !m_image.mapping && CSVUtils::BinaryCache::SourceStamp(m_cfg, stamp.size, stamp.mtime);
+  }
+  // 解析结果连同其缓冲区一起交给版本化存储，作为新的基础版本
+  void ParseContent() override {
+    if (m_image.mapping) {
+      if (!m_parser.LoadImage(m_image.mapping, m_image.content, m_image.image))
+        throw ExceptionManager::CSVException("Invalid bundled table image for " + m_cfg);
+      m_source_bytes.store(m_image.content.size(), std::memory_order_relaxed);
+    } else {
+      m_parser.ParseDataFromCSV(m_cfg);
+      std::error_code ec;
+      const auto sourceBytes = std::filesystem::file_size(m_cfg, ec);
+      m_source_bytes.store(ec ? 0 : static_cast<size_t>(sourceBytes), std::memory_order_relaxed);
+    }
+    auto source = m_parser.GetSourceBuffer();
+    std::lock_guard<std::mutex> lock(m_save_mutex);
+    m_profile = m_parser.GetParseProfile();
+    m_persisted_rows = m_parser.GetCSVDataSize();
+    m_versions.Reset(m_parser.TakeCSVData(), std::move(source));
+  }
+
+public:
+  TableSnapshot GetSnapshot() const override { return m_versions.Acquire(); }
+  VersionedSnapshot GetVersionedSnapshot() const override { return m_versions.AcquireVersioned(); }
+  std::any OnQuery(QueryStrategyCallback query) override {
+    auto snapshot = m_versions.Acquire();
+    return query ? query(*snapshot) : std::vector<std::string_view>();
+  }
   const std::vector<std::string_view> &GetColumnNames() const override {
     return m_parser.GetColumnNames();
   };
 
   /**
-   * @brief 将一行或多行“拟合后的字符串”写入CSVParser。
+   * @brief 将一行或多行“拟合后的字符串”追加为新版本，正在查询旧版本的线程不受影响
    * @param fittedRows 多行，每行是 std::vector<std::string> 类型
-   * @return 若插入成功则返回true；有异常则返回false或抛出
+   * @return 若插入成功则返回true；有异常则返回false，当前版本保持不变
    */
   bool AddFittedRows(const std::vector<std::vector<std::string>> &fittedRows) override {
     try {
-      for (auto &rowStrings : fittedRows) {
-        // 1) 先缓存到本地，避免string_view悬空问题
-        m_fitted_data_cache.push_back(rowStrings);
-
-        // 2) 把这行的末尾取出，用 string_view 封装
-        auto &backRow = m_fitted_data_cache.back();
-        std::vector<std::string_view> rowView;
-        rowView.reserve(backRow.size());
-        for (auto &str : backRow) {
-          rowView.push_back(str);
-        }
-
-        // 3) 通过 OnAdd 往CSVParser内部追加
-        m_parser.OnAdd([&rowView](CSVParser::DataContainer &data) { data.emplace_back(rowView); });
-      }
+      m_versions.AppendRows(fittedRows);
     } catch (const std::exception &ex) {
       std::cerr << "[GenericParser] AddFittedRows failed: " << ex.what() << std::endl;
       return false;
     }
     return true;
   }
+  // 只追加上次解析/写出之后新增的行
+  void SaveFittedRows() override {
+    std::lock_guard<std::mutex> lock(m_save_mutex);
+    auto snapshot = m_versions.Acquire();
+    CSVWriter writer;
+    writer.AppendRows(m_cfg, *snapshot, m_persisted_rows);
+    m_persisted_rows = snapshot->size();
+  }
+  size_t MemoryBytes() const override {
+    return m_versions.Acquire()->MemoryBytes() + m_source_bytes.load(std::memory_order_relaxed) +
+           m_versions.ArenaBytes() + IndexBytes();
+  }
+  bool HasUnsavedRows() const override {
+    std::lock_guard<std::mutex> lock(m_save_mutex);
+    return m_versions.Acquire()->size() > m_persisted_rows;
+  }
+  void SetImageSource(CFGTableImage image) override { m_image = std::move(image); }
+  void SetBinaryCacheDir(const std::string &cache_dir) override { m_parser.EnableBinaryCache(cache_dir); }
+  bool ExportImage(std::string &content, std::string &image) const override {
+    CSVParser parser(ParseMode::Synchronous);
+    Configure(parser);
+    parser.ParseDataFromCSV(m_cfg);
+    return parser.ExportImage(content, image);
+  }
+  ParseProfile GetParseProfile() const override {
+    std::lock_guard<std::mutex> lock(m_save_mutex);
+    return m_profile;
+  }
 
 private:
+  // 模块声明了列类型时，数值列在加载时一次性转换
+  static void Configure(CSVParser &parser) {
+    if constexpr (requires { typename Module::Schema; }) {
+      parser.SetColumnSchema(Module::Schema::ToColumnSchema());
+    }
+  }
+
   CSVParser m_parser;
   std::string m_cfg;
-  std::vector<std::vector<std::string>> m_fitted_data_cache;
+  VersionedTable m_versions;
+  mutable std::mutex m_save_mutex;
+  size_t m_persisted_rows = 0; // 已写入文件的行数，受m_save_mutex保护
+  ParseProfile m_profile;      // 受m_save_mutex保护
+  std::atomic<size_t> m_source_bytes{0};
+  CFGTableImage m_image; // mapping为空表示从m_cfg读文件
 };
 namespace RX {
 struct FE {
   static constexpr inline const char *ModuleName = "FE";
+  using Schema = CSVSchema<Column<"Freq", double>, Column<"Power", double>>;
 };
 struct REC {
   static constexpr inline const char *ModuleName = "REC";
+  using Schema = CSVSchema<Column<"Freq", double>, Column<"Power", double>>;
 };
 struct HW {
   static constexpr inline const char *ModuleName = "HW";
+  using Schema = CSVSchema<Column<"PortNo", uint32_t>, Column<"FE", uint32_t>, Column<"REC", uint32_t>>;
 };
 } // namespace RX
 
@@ -106,6 +283,7 @@ struct MOD {
 };
 struct HW {
   static constexpr inline const char *ModuleName = "CW/HW";
+  using Schema = CSVSchema<Column<"PortNo", uint32_t>>;
 };
 struct SGC1 {
   static constexpr inline const char *ModuleName = "CW/SGC1";
@@ -127,6 +305,7 @@ struct MOD {
 };
 struct HW {
   static constexpr inline const char *ModuleName = "DT/HW";
+  using Schema = CSVSchema<Column<"PortNo", uint32_t>>;
 };
 struct SGC1 {
   static constexpr inline const char *ModuleName = "DT/SGC1";
@@ -148,6 +327,7 @@ struct MOD {
 };
 struct HW {
   static constexpr inline const char *ModuleName = "MOD/HW";
+  using Schema = CSVSchema<Column<"PortNo", uint32_t>>;
 };
 struct SGC1 {
   static constexpr inline const char *ModuleName = "MOD/SGC1";
@@ -0,0 +1,211 @@
+#ifndef CFGFILEWATCHER_HPP
+#define CFGFILEWATCHER_HPP
+
+#include <cerrno>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "CFGFileNode.hpp"
+
+#if defined(__linux__)
+#define CFG_FILE_WATCHER_INOTIFY
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief 监视配置目录树中CSV文件的新增、修改与删除（Linux下基于inotify）
+ * 事件在后台线程上收集，同一文件的多次事件合并；静默settle时间后把一批变更交给回调，回调在监视线程上执行
+ */
+class CFGFileWatcher {
+public:
+  enum class ChangeKind { Modified, Removed }; // 新增文件也报告为Modified
+  struct FileChange {
+    std::string dir;      // 文件所在目录的完整路径
+    std::string fileName;
+    ChangeKind kind;
+  };
+  using ChangeHandler = std::function<void(const std::vector<FileChange> &)>;
+
+  static constexpr bool IsSupported() {
+#ifdef CFG_FILE_WATCHER_INOTIFY
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  CFGFileWatcher() = default;
+  CFGFileWatcher(const CFGFileWatcher &) = delete;
+  CFGFileWatcher &operator=(const CFGFileWatcher &) = delete;
+  ~CFGFileWatcher() { Stop(); }
+
+  void Start(const std::string &root, ChangeHandler handler,
+             std::chrono::milliseconds settle = std::chrono::milliseconds(100)) {
+#ifdef CFG_FILE_WATCHER_INOTIFY
+    Stop();
+    m_inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    m_wakeup_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_inotify_fd < 0 || m_wakeup_fd < 0) {
+      CloseFds();
+      throw CFGFileNodeException("Failed to initialise inotify for: " + root);
+    }
+    // 根目录本身无法监视时不启动线程，否则会一直报告运行却收不到任何变更
+    std::vector<FileChange> unused;
+    if (!WatchTree(root, unused)) {
+      CloseFds();
+      m_watches.clear();
+      throw CFGFileNodeException("Cannot watch config directory: " + root);
+    }
+    m_handler = std::move(handler);
+    m_settle = settle;
+    m_thread = std::thread([this] { Run(); });
+#else
+    (void)root;
+    (void)handler;
+    (void)settle;
+    throw CFGFileNodeException("Config file watching is not supported on this platform");
+#endif
+  }
+
+  void Stop() {
+#ifdef CFG_FILE_WATCHER_INOTIFY
+    if (m_thread.joinable()) {
+      uint64_t one = 1;
+      [[maybe_unused]] auto written = write(m_wakeup_fd, &one, sizeof(one));
+      m_thread.join();
+    }
+    CloseFds();
+    m_watches.clear();
+#endif
+  }
+  bool IsRunning() const { return m_thread.joinable(); }
+
+private:
+  static bool IsConfigFile(const std::string &fileName) {
+    return std::filesystem::path(fileName).extension() == ".csv";
+  }
+
+#ifdef CFG_FILE_WATCHER_INOTIFY
+  static constexpr uint32_t kWatchMask =
+      IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE | IN_CREATE | IN_ONLYDIR;
+
+  // 监视dir及其所有子目录；监视建立前已存在的CSV追加到found（用于新建目录时补报）
+  // 返回dir本身是否监视成功，子目录失败只记录日志
+  bool WatchTree(const std::string &dir, std::vector<FileChange> &found) {
+    int wd = inotify_add_watch(m_inotify_fd, dir.c_str(), kWatchMask);
+    if (wd < 0) {
+      std::cerr << "[CFGFileWatcher] Cannot watch " << dir << std::endl;
+      return false;
+    }
+    m_watches[wd] = dir;
+    std::error_code ec;
+    for (const auto &entry : std::filesystem::directory_iterator(dir, ec)) {
+      auto name = entry.path().filename().string();
+      if (entry.is_directory(ec))
+        WatchTree(entry.path().generic_string(), found);
+      else if (IsConfigFile(name))
+        found.push_back({dir, name, ChangeKind::Modified});
+    }
+    return true;
+  }
+
+  void Run() {
+    std::vector<FileChange> pending;
+    alignas(inotify_event) char buffer[16 * 1024];
+    while (true) {
+      pollfd fds[2] = {{m_inotify_fd, POLLIN, 0}, {m_wakeup_fd, POLLIN, 0}};
+      // 有待处理变更时等待settle时间，期间无新事件即提交一批
+      int ready = poll(fds, 2, pending.empty() ? -1 : static_cast<int>(m_settle.count()));
+      if (ready < 0 && errno == EINTR)
+        continue;
+      if (ready < 0 || (fds[1].revents & POLLIN))
+        break;
+      if (ready == 0) {
+        Dispatch(pending);
+        continue;
+      }
+      ssize_t length;
+      while ((length = read(m_inotify_fd, buffer, sizeof(buffer))) > 0) {
+        for (char *ptr = buffer; ptr < buffer + length;) {
+          const auto *event = reinterpret_cast<const inotify_event *>(ptr);
+          HandleEvent(*event, pending);
+          ptr += sizeof(inotify_event) + event->len;
+        }
+      }
+    }
+  }
+
+  void HandleEvent(const inotify_event &event, std::vector<FileChange> &pending) {
+    if (event.mask & IN_Q_OVERFLOW) {
+      std::cerr << "[CFGFileWatcher] Event queue overflow, some changes were dropped" << std::endl;
+      return;
+    }
+    auto dir = m_watches.find(event.wd);
+    if (event.mask & IN_IGNORED) {
+      if (dir != m_watches.end())
+        m_watches.erase(dir);
+      return;
+    }
+    if (dir == m_watches.end() || event.len == 0)
+      return;
+    const std::string name(event.name);
+    if (event.mask & IN_ISDIR) {
+      if (event.mask & (IN_CREATE | IN_MOVED_TO))
+        WatchTree(dir->second + "/" + name, pending);
+      return;
+    }
+    if (!IsConfigFile(name))
+      return;
+    // 新建文件在写完关闭时以IN_CLOSE_WRITE报告，IN_CREATE本身不处理
+    if (event.mask & (IN_CLOSE_WRITE | IN_MOVED_TO))
+      pending.push_back({dir->second, name, ChangeKind::Modified});
+    else if (event.mask & (IN_DELETE | IN_MOVED_FROM))
+      pending.push_back({dir->second, name, ChangeKind::Removed});
+  }
+
+  // 同一文件只保留最后一次变更，按最后出现的顺序交给回调
+  void Dispatch(std::vector<FileChange> &pending) {
+    std::vector<FileChange> batch;
+    std::unordered_map<std::string, size_t> latest;
+    for (size_t i = 0; i < pending.size(); ++i)
+      latest[pending[i].dir + "/" + pending[i].fileName] = i;
+    for (size_t i = 0; i < pending.size(); ++i) {
+      if (latest[pending[i].dir + "/" + pending[i].fileName] == i)
+        batch.push_back(std::move(pending[i]));
+    }
+    pending.clear();
+    try {
+      m_handler(batch);
+    } catch (const std::exception &ex) {
+      std::cerr << "[CFGFileWatcher] Change handler failed: " << ex.what() << std::endl;
+    }
+  }
+
+  void CloseFds() {
+    if (m_inotify_fd >= 0)
+      close(m_inotify_fd);
+    if (m_wakeup_fd >= 0)
+      close(m_wakeup_fd);
+    m_inotify_fd = m_wakeup_fd = -1;
+  }
+
+  int m_inotify_fd = -1;
+  int m_wakeup_fd = -1; // Stop时写入以唤醒poll
+  std::unordered_map<int, std::string> m_watches; // 监视描述符 -> 目录，只在监视线程与Start/Stop中访问
+#endif
+
+  ChangeHandler m_handler;
+  std::chrono::milliseconds m_settle{100};
+  std::thread m_thread;
+};
+
+#endif // CFGFILEWATCHER_HPP
@@ -0,0 +1,150 @@
+#ifndef CFGLOADREPORT_HPP
+#define CFGLOADREPORT_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../CSVReader.h"
+
+// 单个配置文件的加载记录，分阶段耗时与行列数取自CSVParser::GetParseProfile
+struct CFGFileLoadStat {
+  std::string path;
+  uintmax_t bytes = 0;
+  size_t rows = 0;
+  size_t cells = 0;
+  double ioMs = 0;
+  double splitMs = 0;
+  double validateMs = 0;
+  double parseMs = 0; // 创建解析器到解析完成的总耗时，含以上各阶段与建立版本化存储等其余开销
+  size_t estimatedPeakBytes = 0; // 按容量估算的解析期峰值，非实测分配
+  ParseProfile::Source source = ParseProfile::Source::File;
+  std::string error; // 为空表示解析成功
+};
+
+/**
+ * @brief 配置加载报告：最近一次LoadAllCFGFiles的逐文件记录，之后LoadCFGFile与按需加载的文件按路径追加或替换
+ * 可按任一指标从大到小排序，导出JSON用于找出最慢的表、比较不同版本的启动耗时
+ */
+struct CFGLoadReport {
+  enum class SortKey { ParseTime, IoTime, SplitTime, ValidateTime, Bytes, Rows, Cells, EstimatedPeakBytes };
+
+  std::vector<CFGFileLoadStat> files;
+  double wallMs = 0; // LoadAllCFGFiles从枚举到提交的总耗时；并行加载时小于各文件parseMs之和
+
+  // 按key从大到小稳定排序
+  CFGLoadReport &SortBy(SortKey key) {
+    std::stable_sort(files.begin(), files.end(), [key](const CFGFileLoadStat &a, const CFGFileLoadStat &b) {
+      return Metric(a, key) > Metric(b, key);
+    });
+    return *this;
+  }
+  // 各文件之和，estimatedPeakBytes取最大值
+  CFGFileLoadStat Total() const {
+    CFGFileLoadStat total;
+    for (const auto &file : files) {
+      total.bytes += file.bytes;
+      total.rows += file.rows;
+      total.cells += file.cells;
+      total.ioMs += file.ioMs;
+      total.splitMs += file.splitMs;
+      total.validateMs += file.validateMs;
+      total.parseMs += file.parseMs;
+      total.estimatedPeakBytes = std::max(total.estimatedPeakBytes, file.estimatedPeakBytes);
+    }
+    return total;
+  }
+  // {"wallMs":..,"total":{..},"files":[{..},..]}，文件按当前顺序输出
+  std::string ToJson() const {
+    std::string out = "{\"wallMs\":" + FormatMs(wallMs) + ",\"total\":";
+    AppendStat(out, Total(), false);
+    out += ",\"files\":[";
+    for (size_t i = 0; i < files.size(); ++i) {
+      if (i != 0)
+        out += ',';
+      AppendStat(out, files[i], true);
+    }
+    out += "]}";
+    return out;
+  }
+
+  static const char *SourceName(ParseProfile::Source source) {
+    switch (source) {
+    case ParseProfile::Source::Snapshot:
+      return "snapshot";
+    case ParseProfile::Source::Image:
+      return "image";
+    default:
+      return "file";
+    }
+  }
+
+private:
+  static double Metric(const CFGFileLoadStat &stat, SortKey key) {
+    switch (key) {
+    case SortKey::IoTime:
+      return stat.ioMs;
+    case SortKey::SplitTime:
+      return stat.splitMs;
+    case SortKey::ValidateTime:
+      return stat.validateMs;
+    case SortKey::Bytes:
+      return static_cast<double>(stat.bytes);
+    case SortKey::Rows:
+      return static_cast<double>(stat.rows);
+    case SortKey::Cells:
+      return static_cast<double>(stat.cells);
+    case SortKey::EstimatedPeakBytes:
+      return static_cast<double>(stat.estimatedPeakBytes);
+    default:
+      return stat.parseMs;
+    }
+  }
+
+  static std::string FormatMs(double ms) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.3f", ms);
+    return buffer;
+  }
+  static void AppendString(std::string &out, std::string_view text) {
+    out += '"';
+    for (unsigned char c : text) {
+      if (c == '"' || c == '\\') {
+        out += '\\';
+        out += static_cast<char>(c);
+      } else if (c < 0x20) {
+        char escaped[8];
+        std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+        out += escaped;
+      } else {
+        out += static_cast<char>(c);
+      }
+    }
+    out += '"';
+  }
+  static void AppendStat(std::string &out, const CFGFileLoadStat &stat, bool withFile) {
+    out += '{';
+    if (withFile) {
+      out += "\"path\":";
+      AppendString(out, stat.path);
+      out += ",\"source\":";
+      AppendString(out, SourceName(stat.source));
+      out += ',';
+    }
+    out += "\"bytes\":" + std::to_string(stat.bytes) + ",\"rows\":" + std::to_string(stat.rows) +
+           ",\"cells\":" + std::to_string(stat.cells) + ",\"ioMs\":" + FormatMs(stat.ioMs) +
+           ",\"splitMs\":" + FormatMs(stat.splitMs) + ",\"validateMs\":" + FormatMs(stat.validateMs) +
+           ",\"parseMs\":" + FormatMs(stat.parseMs) +
+           ",\"estimatedPeakBytes\":" + std::to_string(stat.estimatedPeakBytes);
+    if (withFile && !stat.error.empty()) {
+      out += ",\"error\":";
+      AppendString(out, stat.error);
+    }
+    out += '}';
+  }
+};
+
+#endif // CFGLOADREPORT_HPP
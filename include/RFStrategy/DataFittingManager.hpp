@@ -64,10 +64,11 @@ struct FreqPowerNearbyDataPolicy {
   FittingHelper::DataPoints operator()(const DataQueryEngine &engine,
                                        const FittingParams &params) const {
     FittingHelper::DataPoints dataPoints;
-    const auto &allRows = engine.GetOwnership()->GetModuleCFGData();
-    for (const auto &row : allRows) {
-      double freq = std::stod(std::string{row[0]});
-      double value = std::stod(std::string{row[1]});
+    const auto snapshot = engine.GetOwnership()->GetSnapshot();
+    const auto &allRows = *snapshot;
+    for (size_t i = 0; i < allRows.size(); ++i) {
+      double freq = allRows.NumericAt<double>(i, 0);
+      double value = allRows.NumericAt<double>(i, 1);
       if (std::abs(params.freq - freq) < 10e6 &&
           std::abs(params.power.value_or(0) - value) < 10e6) {
         dataPoints.emplace_back(freq, value);
@@ -81,7 +82,8 @@ struct FreqPowerNearbyDataPolicy {
 //   FittingHelper::FittingRows operator()(const DataQueryEngine &engine,
 //                                         const FittingParams &params) const {
 //     FittingHelper::FittingRows dataRows;
-//     const auto &allRows = engine.GetOwnership()->GetModuleCFGData();
+//     const auto snapshot = engine.GetOwnership()->GetSnapshot();
+//     const auto &allRows = *snapshot;
 //     if (allRows.empty())
 //       return dataRows;
 //     auto fitFreq = params.freq / 1e6;
@@ -9,25 +9,35 @@
 #include <unordered_set>
 #include <vector>
 
-using Row = std::vector<std::string_view>; // 单行数据
-using DataContainer = std::vector<Row>;    // 匹配的数据集合
+using Row = CSVTable::RowView;               // 单行数据（视图）
+using DataContainer = CSVParser::DataContainer; // 扁平化表格
+using MatchedRows = std::vector<Row>;         // 匹配的数据集合
 
 class QueryResult {
 public:
   QueryResult() = default;
   size_t GetMatchedRowCount() const { return matchedRows.size(); }
-  const DataContainer &GetMatchedRows() const { return matchedRows; }
-  void AddMatchedRow(const Row &row) { matchedRows.push_back(row); }
+  const MatchedRows &GetMatchedRows() const { return matchedRows; }
+  void AddMatchedRow(Row row) { matchedRows.push_back(row); }
   bool IsEmpty() const { return matchedRows.empty(); }
+  // 持有被查询的快照，匹配行在结果存活期间保持有效
+  void RetainSnapshot(CFGFileParser::TableSnapshot snapshot) { m_snapshot = std::move(snapshot); }
 
 private:
-  DataContainer matchedRows; // 匹配的行数据
+  MatchedRows matchedRows; // 匹配的行数据
+  CFGFileParser::TableSnapshot m_snapshot;
 };
 
 class IQueryPolicy {
 public:
   virtual ~IQueryPolicy() = default;
   virtual bool Execute(const DataContainer &data, QueryResult &result) const = 0;
+  // 由DataQueryEngine调用，可使用解析器上按版本缓存的索引；默认直接扫描快照
+  virtual bool ExecuteIndexed(const CFGFileParser &parser, const CFGFileParser::VersionedSnapshot &snapshot,
+                              QueryResult &result) const {
+    (void)parser;
+    return Execute(*snapshot.table, result);
+  }
 };
 
 class PortNoQueryPolicy : public IQueryPolicy {
@@ -36,9 +46,9 @@ public:
       : m_portNos(portNos.begin(), portNos.end()) {}
 
   bool Execute(const DataContainer &data, QueryResult &result) const override {
-    for (const auto &row : data) {
-      if (Matches(row)) {
-        result.AddMatchedRow(row);
+    for (size_t i = 0; i < data.size(); ++i) {
+      if (Matches(data, i)) {
+        result.AddMatchedRow(data[i]);
       }
     }
     return !result.GetMatchedRows().empty();
@@ -47,28 +57,51 @@ public:
 private:
   std::unordered_set<uint32_t> m_portNos; // 批量端口集合
 
-  // 判断行是否匹配条件
-  bool Matches(const Row &row) const {
-    return m_portNos.find(stoi(std::string{row[0]})) != m_portNos.end();
+  // 判断行是否匹配条件，PortNo列已类型化时直接读取数值
+  bool Matches(const DataContainer &data, size_t row) const {
+    return m_portNos.find(data.NumericAt<uint32_t>(row, 0)) != m_portNos.end();
   }
 };
 
 class FreqPowerQueryPolicy : public IQueryPolicy {
 public:
   FreqPowerQueryPolicy(double freq, double power) : m_freq(freq), m_power(power) {}
+  // 经解析器缓存的有序索引做两次二分查找，按行号升序返回，与逐行扫描的结果一致
+  bool ExecuteIndexed(const CFGFileParser &parser, const CFGFileParser::VersionedSnapshot &snapshot,
+                      QueryResult &result) const override {
+    const auto &data = *snapshot.table;
+    auto index = parser.GetFreqPowerIndex(snapshot);
+    for (auto row : index->Find(m_freq, m_power, data.size())) {
+      result.AddMatchedRow(data[row]);
+    }
+    return !result.IsEmpty();
+  }
   bool Execute(const DataContainer &data, QueryResult &result) const override {
-    for (const auto &row : data) {
-      if (Matches(row)) {
-        result.AddMatchedRow(row);
+    data.ForEachSegment([&](const DataContainer &segment, size_t) {
+      auto freqs = segment.DoubleColumn(0);
+      auto powers = segment.DoubleColumn(1);
+      if (!freqs.empty() && !powers.empty()) {
+        // Freq/Power已类型化：直接扫描段内的连续数组
+        for (size_t i = 0; i < segment.size(); ++i) {
+          if (freqs[i] == m_freq && powers[i] == m_power) {
+            result.AddMatchedRow(segment[i]);
+          }
+        }
+        return;
       }
-    }
+      for (size_t i = 0; i < segment.size(); ++i) {
+        if (Matches(segment, i)) {
+          result.AddMatchedRow(segment[i]);
+        }
+      }
+    });
     return !result.IsEmpty();
   }
 
 private:
-  bool Matches(const Row &row) const {
-    double freq = stod(std::string{row[0]});
-    double power = stod(std::string{row[1]});
+  bool Matches(const DataContainer &data, size_t row) const {
+    double freq = data.NumericAt<double>(row, 0);
+    double power = data.NumericAt<double>(row, 1);
     return freq == m_freq && power == m_power;
   }
 
@@ -76,13 +109,48 @@ private:
   double m_power;
 };
 
+// 按列取值等值匹配；该列为Dictionary列时逐段查出编码（各段字典独立），段内逐行只做整数比较
+class ColumnEqualsQueryPolicy : public IQueryPolicy {
+public:
+  ColumnEqualsQueryPolicy(size_t column, std::string value) : m_column(column), m_value(std::move(value)) {}
+  bool Execute(const DataContainer &data, QueryResult &result) const override {
+    data.ForEachSegment([&](const DataContainer &segment, size_t) {
+      if (segment.TypeOf(m_column) == ColumnType::Dictionary) {
+        const auto &dictionary = segment.Dictionary(m_column);
+        const uint32_t code = dictionary.Find(m_value);
+        if (code == DictionaryColumn::kNotFound)
+          return;
+        auto codes = dictionary.Codes();
+        for (size_t i = 0; i < codes.size(); ++i) {
+          if (codes[i] == code) {
+            result.AddMatchedRow(segment[i]);
+          }
+        }
+        return;
+      }
+      for (auto row : segment) {
+        if (m_column < row.size() && row[m_column] == m_value) {
+          result.AddMatchedRow(row);
+        }
+      }
+    });
+    return !result.IsEmpty();
+  }
+
+private:
+  size_t m_column;
+  std::string m_value;
+};
+
 class DataQueryEngine {
 public:
   DataQueryEngine(CFGFileParser::CFGFileParserPtr parser) : m_parser(std::move(parser)) {}
 
   QueryResult ExecuteQuery(const IQueryPolicy &policy) {
     QueryResult result;
-    [[maybe_unused]] bool success = policy.Execute(m_parser->GetModuleCFGData(), result);
+    auto snapshot = m_parser->GetVersionedSnapshot();
+    [[maybe_unused]] bool success = policy.ExecuteIndexed(*m_parser, snapshot, result);
+    result.RetainSnapshot(std::move(snapshot.table));
     return result;
   }
 
@@ -91,8 +159,7 @@ public:
   // 可选“验收式”再查询，校验插入的数据确实可见
   [[maybe_unused]] bool
   VerifyRowExists(std::function<bool(const CSVParser::DataContainer &)> checker) {
-    auto data = m_parser->GetModuleCFGData();
-    return checker(data);
+    return checker(*m_parser->GetSnapshot());
   }
 
   // 缓存插值数据（单行或多行）
@@ -0,0 +1,165 @@
+#ifndef FREQ_POWER_INDEX_HPP
+#define FREQ_POWER_INDEX_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <tuple>
+#include <vector>
+
+#include "../CSVTable.hpp"
+
+/**
+ * @brief Freq/Power两列（第0、1列）的有序索引：第一层是排好序的频点，每个频点下是按功率排序的(功率, 行号)数组
+ * 精确匹配为两次二分查找。索引不可变，由CFGFileParser按内容版本缓存；表只在末尾追加行时用Extend增量更新，
+ * 只复制新行落入的频点的功率数组，其余频点与旧索引共享
+ */
+class FreqPowerIndex {
+public:
+  using RowId = uint32_t;
+  struct Entry {
+    double power;
+    RowId row;
+  };
+  using Bucket = std::vector<Entry>; // 按(power, row)升序
+
+  static constexpr size_t kFreqColumn = 0;
+  static constexpr size_t kPowerColumn = 1;
+
+  static std::shared_ptr<const FreqPowerIndex> Build(const CSVTable &table, uint64_t version, uint64_t base) {
+    auto index = std::make_shared<FreqPowerIndex>();
+    index->m_version = version;
+    index->m_base = base;
+    index->Insert(table, 0);
+    return index;
+  }
+  // prev须基于同一base，即table是prev所索引的表在末尾追加行后的版本
+  static std::shared_ptr<const FreqPowerIndex> Extend(const FreqPowerIndex &prev, const CSVTable &table,
+                                                      uint64_t version) {
+    auto index = std::make_shared<FreqPowerIndex>(prev);
+    index->m_version = version;
+    index->Insert(table, prev.m_rows);
+    return index;
+  }
+
+  /**
+   * @brief 与(freq, power)精确相等的行号，升序
+   * @param row_limit 只返回小于它的行号，用较新的索引查询同一base下较旧的快照时传入快照行数
+   */
+  std::vector<RowId> Find(double freq, double power, size_t row_limit = SIZE_MAX) const {
+    std::vector<RowId> rows;
+    auto freqIt = std::lower_bound(m_freqs.begin(), m_freqs.end(), freq);
+    if (freqIt == m_freqs.end() || *freqIt != freq)
+      return rows;
+    const auto &bucket = *m_buckets[freqIt - m_freqs.begin()];
+    auto first = std::lower_bound(bucket.begin(), bucket.end(), power,
+                                  [](const Entry &entry, double value) { return entry.power < value; });
+    for (; first != bucket.end() && first->power == power && first->row < row_limit; ++first)
+      rows.push_back(first->row);
+    return rows;
+  }
+
+  uint64_t Version() const noexcept { return m_version; }
+  uint64_t Base() const noexcept { return m_base; }
+  size_t RowCount() const noexcept { return m_rows; }
+  size_t FrequencyCount() const noexcept { return m_freqs.size(); }
+  // 按容量估算，共享的功率数组也计入
+  size_t MemoryBytes() const noexcept {
+    size_t bytes = m_freqs.capacity() * sizeof(double) + m_buckets.capacity() * sizeof(m_buckets[0]);
+    for (const auto &bucket : m_buckets)
+      bytes += bucket->capacity() * sizeof(Entry);
+    return bytes;
+  }
+
+private:
+  struct Pending {
+    double freq;
+    double power;
+    RowId row;
+    bool operator<(const Pending &other) const {
+      return std::tie(freq, power, row) < std::tie(other.freq, other.power, other.row);
+    }
+  };
+
+  // 索引table中[begin, table.size())的行；Freq或Power为NaN的行不会被精确匹配到，不入索引
+  void Insert(const CSVTable &table, size_t begin) {
+    std::vector<Pending> pending;
+    pending.reserve(table.size() - begin);
+    // 逐段读取，段内的类型化列是连续数组
+    table.ForEachSegment([&](const CSVTable &segment, size_t firstRow) {
+      if (firstRow + segment.size() <= begin)
+        return;
+      const auto freqs = segment.DoubleColumn(kFreqColumn);
+      const auto powers = segment.DoubleColumn(kPowerColumn);
+      auto valueAt = [&segment](std::span<const double> typed, size_t row, size_t col) {
+        return typed.empty() ? segment.NumericAt<double>(row, col) : typed[row];
+      };
+      for (size_t row = begin > firstRow ? begin - firstRow : 0; row < segment.size(); ++row) {
+        const double freq = valueAt(freqs, row, kFreqColumn);
+        const double power = valueAt(powers, row, kPowerColumn);
+        if (!std::isnan(freq) && !std::isnan(power))
+          pending.push_back({freq, power, static_cast<RowId>(firstRow + row)});
+      }
+    });
+    m_rows = table.size();
+    if (pending.empty())
+      return;
+    std::sort(pending.begin(), pending.end());
+
+    // 把按频点分组的新行与已有频点按序归并；新行的行号都大于已有行，同功率时排在后面
+    std::vector<double> freqsOut;
+    std::vector<std::shared_ptr<const Bucket>> bucketsOut;
+    freqsOut.reserve(m_freqs.size() + pending.size());
+    bucketsOut.reserve(m_freqs.size() + pending.size());
+    size_t old = 0;
+    for (size_t i = 0; i < pending.size();) {
+      const double freq = pending[i].freq;
+      size_t end = i;
+      while (end < pending.size() && pending[end].freq == freq)
+        ++end;
+      for (; old < m_freqs.size() && m_freqs[old] < freq; ++old) {
+        freqsOut.push_back(m_freqs[old]);
+        bucketsOut.push_back(std::move(m_buckets[old]));
+      }
+      auto bucket = std::make_shared<Bucket>();
+      if (old < m_freqs.size() && m_freqs[old] == freq) {
+        const auto &existing = *m_buckets[old++];
+        bucket->reserve(existing.size() + (end - i));
+        auto from = pending.begin() + i;
+        auto to = pending.begin() + end;
+        auto it = existing.begin();
+        for (; from != to; ++from) {
+          for (; it != existing.end() && it->power <= from->power; ++it)
+            bucket->push_back(*it);
+          bucket->push_back({from->power, from->row});
+        }
+        bucket->insert(bucket->end(), it, existing.end());
+      } else {
+        bucket->reserve(end - i);
+        for (size_t j = i; j < end; ++j)
+          bucket->push_back({pending[j].power, pending[j].row});
+      }
+      freqsOut.push_back(freq);
+      bucketsOut.push_back(std::move(bucket));
+      i = end;
+    }
+    for (; old < m_freqs.size(); ++old) {
+      freqsOut.push_back(m_freqs[old]);
+      bucketsOut.push_back(std::move(m_buckets[old]));
+    }
+    freqsOut.shrink_to_fit();
+    bucketsOut.shrink_to_fit();
+    m_freqs = std::move(freqsOut);
+    m_buckets = std::move(bucketsOut);
+  }
+
+  std::vector<double> m_freqs;                         // 升序，互不相等
+  std::vector<std::shared_ptr<const Bucket>> m_buckets; // 与m_freqs一一对应
+  size_t m_rows = 0;                                   // 已索引的行数
+  uint64_t m_version = 0;
+  uint64_t m_base = 0;
+};
+
+#endif // FREQ_POWER_INDEX_HPP
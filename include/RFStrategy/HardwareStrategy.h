@@ -90,7 +90,7 @@ private:
             std::to_string(slot));
       }
 
-      auto resultData = result.GetMatchedRows();
+      const auto &resultData = result.GetMatchedRows();
       std::vector<SlotData> slotData;
 
       for (const auto &row : resultData) {
@@ -178,7 +178,7 @@ private:
             std::to_string(slot));
       }
 
-      auto resultData = result.GetMatchedRows();
+      const auto &resultData = result.GetMatchedRows();
       std::vector<SlotData> slotData;
 
       for (const auto &row : resultData) {
@@ -283,7 +283,7 @@ private:
             std::to_string(slot));
       }
 
-      auto resultData = result.GetMatchedRows();
+      const auto &resultData = result.GetMatchedRows();
       std::vector<SlotData> slotData;
 
       for (const auto &row : resultData) {
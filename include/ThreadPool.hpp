@@ -0,0 +1,186 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 长期存活的工作窃取线程池：每个工作线程一个双端队列，本地从尾部取，空闲时从其他队列头部窃取
+class ThreadPool {
+public:
+  using Task = std::function<void()>;
+
+  explicit ThreadPool(size_t thread_num = std::thread::hardware_concurrency()) {
+    thread_num = std::max<size_t>(thread_num, 1);
+    for (size_t i = 0; i < thread_num; ++i) {
+      m_queues.push_back(std::make_unique<WorkQueue>());
+    }
+    for (size_t i = 0; i < thread_num; ++i) {
+      m_workers.emplace_back([this, i] { WorkerLoop(i); });
+    }
+  }
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(m_sleep_mutex);
+      m_stop = true;
+    }
+    m_wake.notify_all();
+    for (auto &worker : m_workers) {
+      worker.join();
+    }
+  }
+
+  // 进程内共享的线程池
+  static std::shared_ptr<ThreadPool> Shared() {
+    static std::shared_ptr<ThreadPool> pool = std::make_shared<ThreadPool>();
+    return pool;
+  }
+
+  size_t Size() const noexcept { return m_workers.size(); }
+
+  void Submit(Task task) {
+    // 工作线程提交的任务进自己的队列，外部线程轮询分发
+    size_t index = tls_pool == this ? tls_index : m_next_queue.fetch_add(1) % m_queues.size();
+    // 先计数再入队：任务一入队就可能被取走并递减计数，计数不能先于递增被减
+    {
+      std::lock_guard<std::mutex> lock(m_sleep_mutex);
+      ++m_pending;
+    }
+    {
+      std::lock_guard<std::mutex> lock(m_queues[index]->mutex);
+      m_queues[index]->tasks.push_back(std::move(task));
+    }
+    m_wake.notify_one();
+  }
+
+  // 在调用线程上执行一个待处理任务；没有任务时返回false
+  bool TryRunPendingTask() {
+    Task task;
+    if (!TryPop(tls_pool == this ? tls_index : 0, task))
+      return false;
+    task();
+    return true;
+  }
+
+  /**
+   * @brief 并行执行fn(0..count-1)，调用线程也参与执行并等待全部完成
+   * 下标由调用线程与池内辅助任务从共享计数器中领取，调用线程自己就能做完全部下标，
+   * 不依赖池内线程的进度，因此在池内线程中嵌套调用不会死锁；下标领完后调用线程在条件变量上等待
+   * 其他线程手上的下标完成。任务抛出的第一个异常在全部完成后重新抛出
+   */
+  void ParallelFor(size_t count, const std::function<void(size_t)> &fn) {
+    if (count == 0)
+      return;
+    // 辅助任务可能在ParallelFor返回后才出队，状态由它们共同持有；此时下标已领完，不会再访问fn
+    auto state = std::make_shared<ForState>(count, fn);
+    const size_t helpers = std::min(count - 1, Size());
+    for (size_t i = 0; i < helpers; ++i) {
+      Submit([state] { state->Drain(); });
+    }
+    state->Drain();
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->finished.wait(lock, [&state] { return state->done == state->count; });
+    if (state->first_error)
+      std::rethrow_exception(state->first_error);
+  }
+
+private:
+  struct ForState {
+    ForState(size_t n, const std::function<void(size_t)> &f) : count(n), fn(f) {}
+    // 循环领取下标执行，直到领完
+    void Drain() {
+      for (size_t i = next.fetch_add(1, std::memory_order_relaxed); i < count;
+           i = next.fetch_add(1, std::memory_order_relaxed)) {
+        std::exception_ptr error;
+        try {
+          fn(i);
+        } catch (...) {
+          error = std::current_exception();
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        if (error && !first_error)
+          first_error = error;
+        if (++done == count)
+          finished.notify_all();
+      }
+    }
+
+    const size_t count;
+    const std::function<void(size_t)> &fn;
+    std::atomic<size_t> next{0};
+    std::mutex mutex;
+    std::condition_variable finished;
+    size_t done = 0; // 受mutex保护
+    std::exception_ptr first_error;
+  };
+
+  struct WorkQueue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  bool TryPop(size_t self, Task &task) {
+    {
+      auto &own = *m_queues[self];
+      std::lock_guard<std::mutex> lock(own.mutex);
+      if (!own.tasks.empty()) {
+        task = std::move(own.tasks.back());
+        own.tasks.pop_back();
+        OnPopped();
+        return true;
+      }
+    }
+    for (size_t offset = 1; offset < m_queues.size(); ++offset) {
+      auto &victim = *m_queues[(self + offset) % m_queues.size()];
+      std::lock_guard<std::mutex> lock(victim.mutex);
+      if (!victim.tasks.empty()) {
+        task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        OnPopped();
+        return true;
+      }
+    }
+    return false;
+  }
+  void OnPopped() {
+    std::lock_guard<std::mutex> lock(m_sleep_mutex);
+    --m_pending;
+  }
+
+  void WorkerLoop(size_t index) {
+    tls_pool = this;
+    tls_index = index;
+    while (true) {
+      Task task;
+      if (TryPop(index, task)) {
+        task();
+        continue;
+      }
+      std::unique_lock<std::mutex> lock(m_sleep_mutex);
+      m_wake.wait(lock, [this] { return m_stop || m_pending > 0; });
+      if (m_stop && m_pending == 0)
+        return;
+    }
+  }
+
+  std::vector<std::unique_ptr<WorkQueue>> m_queues;
+  std::vector<std::thread> m_workers;
+  std::mutex m_sleep_mutex;
+  std::condition_variable m_wake;
+  size_t m_pending = 0; // 受m_sleep_mutex保护
+  bool m_stop = false;
+  std::atomic<size_t> m_next_queue{0};
+  static inline thread_local ThreadPool *tls_pool = nullptr;
+  static inline thread_local size_t tls_index = 0;
+};
+
+#endif // THREAD_POOL_HPP
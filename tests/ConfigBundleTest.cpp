@@ -0,0 +1,113 @@
+// 配置包：WriteBundle后以包为根加载，各表的行与按目录加载一致；目录表或表映像损坏时拒绝加载
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "RFStrategy/CFGFileManager.hpp"
+#include "TestCommon.hpp"
+
+using Rows = std::vector<std::vector<std::string>>;
+using Tables = std::map<std::string, Rows>;
+
+// 按(模块/文件)收集已加载的全部表
+static Tables Collect(const CFGLoadReport &report) {
+  auto &manager = CFGFileManager::GetInstance();
+  Tables tables;
+  for (const auto &file : report.files) {
+    const std::filesystem::path path(file.path);
+    const auto moduleName = path.parent_path().filename().string(), fileName = path.filename().string();
+    auto snapshot = manager.GetParser(moduleName, fileName)->GetSnapshot();
+    auto &rows = tables[moduleName + "/" + fileName];
+    for (auto row : *snapshot)
+      rows.emplace_back(row.begin(), row.end());
+  }
+  return tables;
+}
+
+static void FlipByte(const std::string &path, std::streamoff offset) {
+  std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+  file.seekg(offset, offset < 0 ? std::ios::end : std::ios::beg);
+  const auto pos = file.tellg();
+  char byte = 0;
+  file.read(&byte, 1);
+  byte ^= 0x5a;
+  file.seekp(pos);
+  file.write(&byte, 1);
+}
+
+template <typename Fn> static bool Throws(Fn &&fn) {
+  try {
+    fn();
+  } catch (const std::exception &) {
+    return true;
+  }
+  return false;
+}
+
+int main() {
+  Test::TempDir dir("config_bundle");
+  for (const char *module : {"FE", "REC", "HW"})
+    std::filesystem::create_directories(dir.File(std::string("Configs/") + module));
+  dir.Write("Configs/FE/FE1.csv", "Freq,Power\n100,-10\n200,-20\n300,-30\n");
+  dir.Write("Configs/FE/FE2.csv", "Freq,Power\n150.5,-1\n");
+  dir.Write("Configs/REC/REC1.csv", "Freq,Power\n100,1\n200,2\n");
+  dir.Write("Configs/HW/HW.csv", "PortNo,FE,REC\n0,1,1\n1,2,1\n");
+
+  auto &manager = CFGFileManager::GetInstance();
+  manager.SetRootPath(dir.File(""));
+  const auto fromDirectory = Collect(manager.LoadAllCFGFiles());
+  EXPECT(fromDirectory.size() == 4);
+  EXPECT(fromDirectory.at("FE/FE1.csv").size() == 3);
+
+  // 以包为根重新加载，行内容逐格一致，且来自包内映像
+  const auto bundle = dir.File("Configs.cfgbundle");
+  manager.WriteBundle(dir.File(""), bundle);
+  EXPECT(CFGBundle::IsBundle(bundle));
+  for (const auto &entry : std::filesystem::directory_iterator(dir.File("")))
+    EXPECT(entry.path().filename().string().find(".tmp") == std::string::npos); // 临时文件已改名
+  manager.SetRootPath(bundle);
+  const auto report = manager.LoadAllCFGFiles();
+  EXPECT(Collect(report) == fromDirectory);
+  for (const auto &file : report.files)
+    EXPECT(file.source == ParseProfile::Source::Image);
+  EXPECT(manager.GetParser("FE", "FE2.csv")->GetSnapshot()->NumericAt<double>(0, 0) == 150.5);
+
+  // 重写同一个包：改名覆盖，已映射旧包的解析器不受影响
+  auto held = manager.GetParser("FE", "FE1.csv");
+  manager.WriteBundle(dir.File(""), bundle);
+  EXPECT(held->GetSnapshot()->size() == 3);
+
+  // 目录表（位于文件末尾）损坏：哈希不符，SetRootPath拒绝该包
+  const auto badIndex = dir.File("bad_index.cfgbundle");
+  std::filesystem::copy_file(bundle, badIndex);
+  FlipByte(badIndex, -1);
+  EXPECT(Throws([&] { manager.SetRootPath(badIndex); }));
+  // 截断的包同样被拒绝
+  const auto truncated = dir.File("truncated.cfgbundle");
+  std::filesystem::copy_file(bundle, truncated);
+  std::filesystem::resize_file(truncated, std::filesystem::file_size(truncated) / 2);
+  EXPECT(Throws([&] { manager.SetRootPath(truncated); }));
+
+  // 表映像损坏：目录表仍有效，加载该表时映像校验失败并抛异常，同包其他表不受影响
+  const auto badImage = dir.File("bad_image.cfgbundle");
+  std::filesystem::copy_file(bundle, badImage);
+  {
+    const CFGBundle original(bundle);
+    const auto *entry = original.Find("FE", "FE1.csv");
+    EXPECT(entry != nullptr);
+    std::ifstream in(bundle, std::ios::binary);
+    const std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    const auto offset = bytes.find(entry->image);
+    EXPECT(offset != std::string::npos);
+    FlipByte(badImage, static_cast<std::streamoff>(offset + entry->image.size() - 1));
+  }
+  manager.SetRootPath(badImage);
+  EXPECT(Throws([&] { manager.GetParser("FE", "FE1.csv"); }));
+  EXPECT(manager.GetParser("FE", "FE2.csv")->GetSnapshot()->size() == 1);
+
+  manager.Clear();
+  return Test::Failures();
+}
@@ -0,0 +1,93 @@
+// Dictionary列：编码与字典可还原每个单元格，.csvbin快照加载后重新编码一致；
+// ColumnEqualsQueryPolicy按编码匹配，追加尾段后逐段查编码仍得到正确的行
+#include <string>
+#include <vector>
+
+#include "CSVReader.h"
+#include "CSVVersionedTable.hpp"
+#include "RFStrategy/DynamicQueryPolicy.hpp"
+#include "TestCommon.hpp"
+
+static const char *const kModules[] = {"FE", "REC", "HW", "FE", "FE", "REC"};
+
+static void Configure(CSVParser &parser) {
+  parser.SetColumnSchema({{"PortNo", ColumnType::UInt32}, {"Module", ColumnType::Dictionary}});
+}
+
+int main() {
+  Test::TempDir dir("dictionary_column");
+  std::string content = "PortNo,Module\n";
+  for (size_t row = 0; row < std::size(kModules); ++row)
+    content += std::to_string(row) + "," + kModules[row] + "\n";
+  const auto path = dir.Write("ports.csv", content);
+
+  // 编码按首次出现的顺序分配，Decode还原原值
+  CSVParser parser(ParseMode::Synchronous);
+  Configure(parser);
+  parser.ParseDataFromCSV(path);
+  const auto &table = parser.GetCSVData();
+  const auto &dictionary = table.Dictionary(1);
+  EXPECT(table.TypeOf(1) == ColumnType::Dictionary);
+  EXPECT(dictionary.size() == std::size(kModules));
+  EXPECT(dictionary.Values().size() == 3);
+  EXPECT(dictionary.Find("FE") == 0 && dictionary.Find("REC") == 1 && dictionary.Find("HW") == 2);
+  EXPECT(dictionary.Find("MOD") == DictionaryColumn::kNotFound);
+  for (size_t row = 0; row < table.size(); ++row) {
+    EXPECT(dictionary.Decode(dictionary.CodeAt(row)) == kModules[row]);
+    EXPECT(dictionary[row] == table[row][1]);
+  }
+  EXPECT(table.Dictionary(0).size() == 0);
+
+  // 快照不保存字典，加载时由单元格重新编码，编码与首次解析相同
+  {
+    CSVParser writer(ParseMode::Synchronous);
+    Configure(writer);
+    writer.EnableBinaryCache(dir.File("cache"));
+    writer.ParseDataFromCSV(path);
+    CSVParser reader(ParseMode::Synchronous);
+    Configure(reader);
+    reader.EnableBinaryCache(dir.File("cache"));
+    reader.ParseDataFromCSV(path);
+    EXPECT(reader.GetParseProfile().source == ParseProfile::Source::Snapshot);
+    const auto &restored = reader.GetCSVData().Dictionary(1);
+    EXPECT(restored.Values() == dictionary.Values());
+    EXPECT(std::vector<uint32_t>(restored.Codes().begin(), restored.Codes().end()) ==
+           std::vector<uint32_t>(dictionary.Codes().begin(), dictionary.Codes().end()));
+  }
+
+  // 等值查询：命中的行与编码相同的行一致，字典中没有的取值直接返回false
+  {
+    QueryResult result;
+    EXPECT(ColumnEqualsQueryPolicy(1, "FE").Execute(table, result));
+    EXPECT(result.GetMatchedRowCount() == 3);
+    const uint32_t code = dictionary.Find("FE");
+    size_t matched = 0;
+    for (size_t row = 0; row < table.size(); ++row) {
+      if (dictionary.CodeAt(row) == code)
+        EXPECT(result.GetMatchedRows()[matched++].data() == table[row].data());
+    }
+    QueryResult missing;
+    EXPECT(!ColumnEqualsQueryPolicy(1, "MOD").Execute(table, missing));
+    EXPECT(missing.IsEmpty());
+  }
+
+  // 追加行落在尾段，尾段有自己的字典，新取值只出现在尾段
+  {
+    auto source = parser.GetSourceBuffer();
+    VersionedTable versions;
+    versions.Reset(parser.TakeCSVData(), std::move(source));
+    versions.AppendRows({{"6", "MOD"}, {"7", "FE"}});
+    auto snapshot = versions.Acquire();
+    EXPECT(snapshot->Segments().size() == 2);
+    EXPECT(snapshot->Dictionary(1).size() == 0); // 多段表没有统一的编码
+    QueryResult fe, mod;
+    EXPECT(ColumnEqualsQueryPolicy(1, "FE").Execute(*snapshot, fe));
+    EXPECT(fe.GetMatchedRowCount() == 4);
+    EXPECT(fe.GetMatchedRows().back()[0] == "7");
+    EXPECT(ColumnEqualsQueryPolicy(1, "MOD").Execute(*snapshot, mod));
+    EXPECT(mod.GetMatchedRowCount() == 1 && mod.GetMatchedRows()[0][0] == "6");
+    const auto &tail = snapshot->Segments().back()->Dictionary(1);
+    EXPECT(tail.size() == 2 && tail.Find("MOD") == 0 && tail.Find("FE") == 1);
+  }
+  return Test::Failures();
+}
@@ -0,0 +1,89 @@
+// 配置热更新的生命周期：根目录无法监视时Start抛异常且不报告运行；监视中SetRootPath切换到新目录后
+// 在新根上继续监视并重新加载修改的文件，切换到配置包后监视停止
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include "RFStrategy/CFGFileManager.hpp"
+#include "TestCommon.hpp"
+
+template <typename Fn> static bool Throws(Fn &&fn) {
+  try {
+    fn();
+  } catch (const CFGFileNodeException &) {
+    return true;
+  }
+  return false;
+}
+
+// 等待监视线程重新加载，最多约5秒
+template <typename Pred> static bool WaitFor(Pred &&pred) {
+  for (int i = 0; i < 250; ++i) {
+    if (pred())
+      return true;
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  }
+  return pred();
+}
+
+static size_t Rows(const char *name) {
+  return CFGFileManager::GetInstance().GetParser("FE", name)->GetSnapshot()->size();
+}
+
+int main() {
+  Test::TempDir dir("file_watcher");
+  for (const char *root : {"a", "b"}) {
+    std::filesystem::create_directories(dir.File(std::string(root) + "/Configs/FE"));
+    dir.Write(std::string(root) + "/Configs/FE/FE.csv", "Freq,Power\n100,1\n");
+  }
+  std::filesystem::create_directories(dir.File("empty"));
+
+  // 根目录不存在：Start抛异常，不留下运行中的线程
+  {
+    CFGFileWatcher watcher;
+    EXPECT(Throws([&] { watcher.Start(dir.File("missing"), [](const auto &) {}); }));
+    EXPECT(!watcher.IsRunning());
+    watcher.Start(dir.File("a"), [](const auto &) {});
+    EXPECT(watcher.IsRunning());
+    watcher.Stop();
+    EXPECT(!watcher.IsRunning());
+  }
+
+  auto &manager = CFGFileManager::GetInstance();
+  // 没有Configs目录的根无法监视
+  manager.SetRootPath(dir.File("empty"));
+  EXPECT(Throws([&] { manager.StartWatching(); }));
+  EXPECT(!manager.IsWatching());
+
+  // 未监视时切换根不会开始监视
+  manager.SetRootPath(dir.File("a"));
+  EXPECT(!manager.IsWatching());
+  manager.StartWatching(std::chrono::milliseconds(20));
+  EXPECT(manager.IsWatching());
+
+  // 监视中切换到b：继续监视，b中的修改被重新加载，a中的修改不再处理
+  manager.SetRootPath(dir.File("b"));
+  EXPECT(manager.IsWatching());
+  EXPECT(Rows("FE.csv") == 1);
+  dir.Write("b/Configs/FE/FE.csv", "Freq,Power\n100,1\n200,2\n");
+  EXPECT(WaitFor([] { return Rows("FE.csv") == 2; }));
+  dir.Write("a/Configs/FE/FE.csv", "Freq,Power\n100,1\n200,2\n300,3\n");
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  EXPECT(Rows("FE.csv") == 2);
+
+  // 切换到新的目录后无法监视：根已切换，异常表示监视未恢复
+  EXPECT(Throws([&] { manager.SetRootPath(dir.File("empty")); }));
+  EXPECT(!manager.IsWatching());
+
+  // 切换到配置包：包不可监视，监视停止
+  manager.SetRootPath(dir.File("b"));
+  manager.StartWatching(std::chrono::milliseconds(20));
+  const auto bundle = dir.File("b.cfgbundle");
+  manager.WriteBundle(dir.File("b"), bundle);
+  manager.SetRootPath(bundle);
+  EXPECT(!manager.IsWatching());
+  EXPECT(Rows("FE.csv") == 2);
+
+  manager.Clear();
+  return Test::Failures();
+}
@@ -0,0 +1,96 @@
+// Freq/Power索引：精确匹配的行号与逐行扫描一致；同一版本的查询复用已发布的索引，
+// AddFittedRows后按新版本增量更新，旧快照用新索引查询时按其行数截断；重新解析后按新base重建
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "RFStrategy/CFGFileManager.hpp"
+#include "RFStrategy/DynamicQueryPolicy.hpp"
+#include "TestCommon.hpp"
+
+using RowIds = std::vector<FreqPowerIndex::RowId>;
+
+// 逐行扫描得到的匹配行号
+static RowIds Scan(const CSVTable &table, double freq, double power) {
+  RowIds rows;
+  for (size_t row = 0; row < table.size(); ++row) {
+    if (table.NumericAt<double>(row, 0) == freq && table.NumericAt<double>(row, 1) == power)
+      rows.push_back(static_cast<FreqPowerIndex::RowId>(row));
+  }
+  return rows;
+}
+
+int main() {
+  Test::TempDir dir("freq_power_index");
+  std::filesystem::create_directories(dir.File("Configs/FE"));
+  std::string content = "Freq,Power\n";
+  for (int row = 0; row < 200; ++row)
+    content += std::to_string(100 + row % 7) + "," + std::to_string(-(row % 5)) + "\n";
+  dir.Write("Configs/FE/FE.csv", content);
+
+  auto &manager = CFGFileManager::GetInstance();
+  manager.SetRootPath(dir.File(""));
+  auto parser = manager.GetParser("FE", "FE.csv");
+
+  // 首次查询构建索引，之后同一版本的查询拿到同一个索引
+  auto first = parser->GetVersionedSnapshot();
+  auto index = parser->GetFreqPowerIndex(first);
+  EXPECT(index->Base() == first.base && index->Version() == first.number);
+  EXPECT(index->RowCount() == 200 && index->FrequencyCount() == 7);
+  EXPECT(parser->GetFreqPowerIndex(first) == index);
+  for (int freq = 99; freq <= 107; ++freq) {
+    for (int power = -5; power <= 1; ++power)
+      EXPECT(index->Find(freq, power) == Scan(*first.table, freq, power));
+  }
+  EXPECT(index->Find(103, -3) == RowIds({3, 38, 73, 108, 143, 178}));
+
+  // 并发查询同一版本：全部得到已发布的索引，不重复构建
+  {
+    std::vector<std::shared_ptr<const FreqPowerIndex>> seen(4);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < seen.size(); ++t)
+      threads.emplace_back([&, t] { seen[t] = parser->GetFreqPowerIndex(parser->GetVersionedSnapshot()); });
+    for (auto &thread : threads)
+      thread.join();
+    for (const auto &got : seen)
+      EXPECT(got == index);
+  }
+
+  // 追加拟合行：新版本增量更新，新行排在同功率已有行之后，未涉及的频点与旧索引共享
+  EXPECT(parser->AddFittedRows({{"103", "-3"}, {"200", "0"}}));
+  auto second = parser->GetVersionedSnapshot();
+  EXPECT(second.base == first.base && second.number > first.number);
+  auto extended = parser->GetFreqPowerIndex(second);
+  EXPECT(extended != index);
+  EXPECT(extended->Base() == first.base && extended->Version() == second.number);
+  EXPECT(extended->RowCount() == 202 && extended->FrequencyCount() == 8);
+  EXPECT(extended->Find(103, -3) == RowIds({3, 38, 73, 108, 143, 178, 200}));
+  EXPECT(extended->Find(200, 0) == RowIds({201}));
+  EXPECT(extended->Find(101, -1) == Scan(*second.table, 101, -1));
+  EXPECT(index->Find(200, 0).empty()); // 旧索引不变
+
+  // 旧快照复用较新的索引，查询结果按旧快照的行数截断
+  EXPECT(parser->GetFreqPowerIndex(first) == extended);
+  QueryResult oldResult, newResult, scanned;
+  EXPECT(FreqPowerQueryPolicy(103, -3).ExecuteIndexed(*parser, first, oldResult));
+  EXPECT(oldResult.GetMatchedRowCount() == 6);
+  EXPECT(FreqPowerQueryPolicy(103, -3).ExecuteIndexed(*parser, second, newResult));
+  EXPECT(FreqPowerQueryPolicy(103, -3).Execute(*second.table, scanned));
+  EXPECT(newResult.GetMatchedRowCount() == 7 && scanned.GetMatchedRowCount() == 7);
+  for (size_t i = 0; i < newResult.GetMatchedRowCount(); ++i)
+    EXPECT(newResult.GetMatchedRows()[i].data() == scanned.GetMatchedRows()[i].data());
+
+  // 重新解析得到新的base，索引按新内容重建；持有旧base快照的查询不替换新索引
+  dir.Write("Configs/FE/FE.csv", "Freq,Power\n103,-3\n");
+  parser->Reparse();
+  auto third = parser->GetVersionedSnapshot();
+  EXPECT(third.base != first.base);
+  auto rebuilt = parser->GetFreqPowerIndex(third);
+  EXPECT(rebuilt->Base() == third.base && rebuilt->Find(103, -3) == RowIds({0}));
+  auto stale = parser->GetFreqPowerIndex(second);
+  EXPECT(stale->Base() == second.base && stale->Find(103, -3).size() == 7);
+  EXPECT(parser->GetFreqPowerIndex(third) == rebuilt);
+
+  manager.Clear();
+  return Test::Failures();
+}
@@ -0,0 +1,95 @@
+// Lazy模式下多个线程并发GetRow：每行只切分一次，读到的内容与源文件一致；
+// 中途整表切分（GetCSVData）后，此前取得的行视图仍然有效；整表切分中途失败时不残留半张表，可以重试
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CSVReader.h"
+#include "ExceptionManager.hpp"
+#include "TestCommon.hpp"
+
+static std::string Cell(size_t row, size_t col) { return std::to_string(row * 10 + col); }
+
+int main() {
+  constexpr size_t kRows = 20000;
+  constexpr size_t kColumns = 4;
+  constexpr size_t kThreads = 8;
+  Test::TempDir dir("lazy_row_concurrency");
+  std::string content = "A,B,C,D\n";
+  for (size_t row = 0; row < kRows; ++row) {
+    for (size_t col = 0; col < kColumns; ++col)
+      content += Cell(row, col) + (col + 1 == kColumns ? "\n" : ",");
+  }
+  const auto path = dir.Write("lazy.csv", content);
+
+  for (int round = 0; round < 3; ++round) {
+    CSVParser parser(ParseMode::Lazy);
+    parser.ParseDataFromCSV(path);
+    EXPECT(parser.GetCSVDataSize() == kRows);
+
+    std::atomic<size_t> mismatches{0};
+    std::atomic<size_t> done{0};
+    std::vector<std::thread> readers;
+    for (size_t t = 0; t < kThreads; ++t) {
+      readers.emplace_back([&, t] {
+        std::vector<CSVTable::RowView> kept;
+        // 各线程以不同步长遍历，同一行会被多个线程同时首次访问
+        for (size_t i = 0; i < kRows; ++i) {
+          const size_t row = (i * (2 * t + 1)) % kRows;
+          auto view = parser.GetRow(row);
+          if (view.size() != kColumns || view[0] != Cell(row, 0) || view[kColumns - 1] != Cell(row, kColumns - 1))
+            ++mismatches;
+          if (i % 97 == 0)
+            kept.push_back(view);
+          if (t == 0 && i % 1000 == 0)
+            parser.GetLazyStats();
+        }
+        // 其间可能发生了整表切分，先前的视图仍须指向正确内容
+        for (auto view : kept) {
+          if (view.size() != kColumns || view[1].empty())
+            ++mismatches;
+        }
+        ++done;
+      });
+    }
+    // 第二轮起在读者运行期间整表切分
+    if (round > 0) {
+      const auto &table = parser.GetCSVData();
+      EXPECT(table.size() == kRows);
+    }
+    for (auto &reader : readers)
+      reader.join();
+    EXPECT(done == kThreads);
+    EXPECT(mismatches == 0);
+    if (round == 0) {
+      auto stats = parser.GetLazyStats();
+      EXPECT(stats.materialized_rows == kRows);
+      EXPECT(stats.pending_rows == 0);
+    }
+  }
+
+  // 后半部分有无效数值或缺列：每次整表切分都抛异常，已切分的行不会重复追加，仍处于懒切分状态
+  for (const char *bad : {"7,x\n", "7\n"}) {
+    std::string text = "A,B\n";
+    for (size_t row = 0; row < 100; ++row)
+      text += std::to_string(row) + "," + std::to_string(row) + "\n";
+    text += bad;
+    CSVParser parser(ParseMode::Lazy);
+    parser.SetColumnSchema({{"A", ColumnType::UInt32}, {"B", ColumnType::UInt32}});
+    parser.ParseDataFromCSV(dir.Write("bad.csv", text));
+    for (int attempt = 0; attempt < 2; ++attempt) {
+      bool thrown = false;
+      try {
+        parser.GetCSVData();
+      } catch (const ExceptionManager::CSVException &) {
+        thrown = true;
+      }
+      EXPECT(thrown);
+      EXPECT(parser.GetCSVDataSize() == 101);
+      EXPECT(parser.GetLazyStats().rows == 101);
+    }
+    EXPECT(parser.GetRow(50)[0] == "50");
+  }
+  return Test::Failures();
+}
@@ -0,0 +1,84 @@
+// LoadAllCFGFiles：按文件从大到小调度并在线程池上并行解析，报告按调度顺序排列且各项与逐个加载一致；
+// 加载完成的解析器直接驻留，之后GetParser全部命中；任一文件失败时不提交任何结果，报告中记下失败原因
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "RFStrategy/CFGFileManager.hpp"
+#include "TestCommon.hpp"
+
+static std::string Table(size_t rows) {
+  std::string content = "Freq,Power\n";
+  for (size_t row = 0; row < rows; ++row)
+    content += std::to_string(100 + row) + "," + std::to_string(-static_cast<int>(row % 30)) + "\n";
+  return content;
+}
+
+static std::string FileName(const CFGFileLoadStat &stat) { return std::filesystem::path(stat.path).filename(); }
+
+int main() {
+  Test::TempDir dir("load_all");
+  for (const char *module : {"FE", "REC", "HW"})
+    std::filesystem::create_directories(dir.File(std::string("Configs/") + module));
+  // 行数各不相同，文件大小顺序即行数顺序
+  dir.Write("Configs/FE/FE_small.csv", Table(3));
+  dir.Write("Configs/FE/FE_large.csv", Table(4000));
+  dir.Write("Configs/FE/FE_medium.csv", Table(300));
+  dir.Write("Configs/REC/REC.csv", Table(1500));
+  dir.Write("Configs/HW/HW.csv", "PortNo,FE,REC\n0,1,1\n1,2,1\n2,3,2\n3,4,2\n4,5,3\n5,6,3\n");
+  const std::vector<std::string> order = {"FE_large.csv", "REC.csv", "FE_medium.csv", "HW.csv", "FE_small.csv"};
+
+  auto &manager = CFGFileManager::GetInstance();
+  for (auto pool : {std::make_shared<ThreadPool>(3), std::shared_ptr<ThreadPool>()}) {
+    manager.SetRootPath(dir.File(""));
+    const auto before = manager.GetCacheStats();
+    const auto report = manager.LoadAllCFGFiles(pool);
+
+    // 报告按调度顺序（从大到小）排列，行数与文件大小取自各自的解析记录
+    std::vector<std::string> names;
+    for (const auto &file : report.files) {
+      names.push_back(FileName(file));
+      EXPECT(file.error.empty());
+      EXPECT(file.bytes == std::filesystem::file_size(file.path));
+      EXPECT(file.parseMs >= 0 && file.source == ParseProfile::Source::File);
+    }
+    EXPECT(names == order);
+    EXPECT(report.files[0].rows == 4000 && report.files[1].rows == 1500 && report.files[4].rows == 3);
+    EXPECT(report.wallMs > 0);
+    EXPECT(manager.GetLoadReport().files.size() == order.size());
+
+    // 全部已驻留：GetParser只命中，不再解析
+    auto stats = manager.GetCacheStats();
+    EXPECT(stats.residentParsers == order.size());
+    EXPECT(manager.GetParser("FE", "FE_large.csv")->GetSnapshot()->size() == 4000);
+    EXPECT(manager.GetParser("HW", "HW.csv")->GetSnapshot()->NumericAt<uint32_t>(5, 1) == 6);
+    EXPECT(manager.GetParser("REC", "REC.csv")->IsParsed());
+    stats = manager.GetCacheStats();
+    EXPECT(stats.misses == before.misses && stats.hits == before.hits + 3);
+  }
+
+  // 一个文件解析失败：抛异常，其余文件也不提交；报告中保留每个文件的结果与失败原因
+  dir.Write("Configs/FE/FE_bad.csv", "Freq,Power\n100,-1\nabc,-2\n");
+  manager.SetRootPath(dir.File(""));
+  bool thrown = false;
+  try {
+    manager.LoadAllCFGFiles(std::make_shared<ThreadPool>(3));
+  } catch (const CFGFileNodeException &ex) {
+    thrown = std::string(ex.what()).find("FE_bad.csv") != std::string::npos;
+  }
+  EXPECT(thrown);
+  EXPECT(manager.GetCacheStats().residentParsers == 0);
+  const auto failed = manager.GetLoadReport();
+  EXPECT(failed.files.size() == order.size() + 1);
+  size_t errors = 0;
+  for (const auto &file : failed.files) {
+    if (!file.error.empty()) {
+      ++errors;
+      EXPECT(FileName(file) == "FE_bad.csv");
+    }
+  }
+  EXPECT(errors == 1);
+
+  manager.Clear();
+  return Test::Failures();
+}
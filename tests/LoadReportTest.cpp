@@ -0,0 +1,63 @@
+// 加载报告：SortBy按指标从大到小稳定排序，Total求和并取最大的估算峰值，
+// ToJson的字段与转义（引号、反斜杠、控制字符），以及失败文件的error字段
+#include <string>
+#include <vector>
+
+#include "RFStrategy/CFGLoadReport.hpp"
+#include "TestCommon.hpp"
+
+static CFGFileLoadStat Stat(const std::string &path, uintmax_t bytes, size_t rows, double parseMs, size_t peak) {
+  CFGFileLoadStat stat;
+  stat.path = path;
+  stat.bytes = bytes;
+  stat.rows = rows;
+  stat.cells = rows * 2;
+  stat.parseMs = parseMs;
+  stat.estimatedPeakBytes = peak;
+  return stat;
+}
+
+static std::vector<std::string> Paths(const CFGLoadReport &report) {
+  std::vector<std::string> paths;
+  for (const auto &file : report.files)
+    paths.push_back(file.path);
+  return paths;
+}
+
+int main() {
+  CFGLoadReport report;
+  report.files = {Stat("a", 10, 5, 1.5, 300), Stat("b", 30, 5, 0.5, 100), Stat("c", 20, 7, 2.5, 200),
+                  Stat("d", 30, 1, 0.25, 50)};
+
+  // 从大到小；相等时保持原有顺序
+  EXPECT(Paths(report.SortBy(CFGLoadReport::SortKey::ParseTime)) == std::vector<std::string>({"c", "a", "b", "d"}));
+  EXPECT(Paths(report.SortBy(CFGLoadReport::SortKey::Bytes)) == std::vector<std::string>({"b", "d", "c", "a"}));
+  EXPECT(Paths(report.SortBy(CFGLoadReport::SortKey::Rows)) == std::vector<std::string>({"c", "b", "a", "d"}));
+  EXPECT(Paths(report.SortBy(CFGLoadReport::SortKey::EstimatedPeakBytes)) ==
+         std::vector<std::string>({"a", "c", "b", "d"}));
+
+  const auto total = report.Total();
+  EXPECT(total.bytes == 90 && total.rows == 18 && total.cells == 36);
+  EXPECT(total.parseMs == 4.75);
+  EXPECT(total.estimatedPeakBytes == 300);
+
+  // 路径与错误信息中的特殊字符按JSON转义
+  CFGLoadReport escaped;
+  escaped.wallMs = 1.25;
+  escaped.files = {Stat("dir\\\"q\".csv", 8, 1, 0.5, 64), Stat("bad\n\x01.csv", 4, 0, 0.125, 0)};
+  escaped.files[0].source = ParseProfile::Source::Image;
+  escaped.files[1].error = "Invalid \"data\"\tline";
+  EXPECT(escaped.ToJson() ==
+         "{\"wallMs\":1.250,"
+         "\"total\":{\"bytes\":12,\"rows\":1,\"cells\":2,\"ioMs\":0.000,\"splitMs\":0.000,\"validateMs\":0.000,"
+         "\"parseMs\":0.625,\"estimatedPeakBytes\":64},"
+         "\"files\":["
+         "{\"path\":\"dir\\\\\\\"q\\\".csv\",\"source\":\"image\",\"bytes\":8,\"rows\":1,\"cells\":2,"
+         "\"ioMs\":0.000,\"splitMs\":0.000,\"validateMs\":0.000,\"parseMs\":0.500,\"estimatedPeakBytes\":64},"
+         "{\"path\":\"bad\\u000a\\u0001.csv\",\"source\":\"file\",\"bytes\":4,\"rows\":0,\"cells\":0,"
+         "\"ioMs\":0.000,\"splitMs\":0.000,\"validateMs\":0.000,\"parseMs\":0.125,\"estimatedPeakBytes\":0,"
+         "\"error\":\"Invalid \\\"data\\\"\\u0009line\"}"
+         "]}");
+  EXPECT(CFGLoadReport().ToJson().find("\"files\":[]") != std::string::npos);
+  return Test::Failures();
+}
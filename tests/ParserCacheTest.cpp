@@ -0,0 +1,65 @@
+// CFGFileManager的内存预算：按最近使用淘汰（命中也更新使用顺序）、固定的文件不被淘汰，
+// 以及命中、未命中与淘汰计数
+#include <memory>
+#include <string>
+
+#include "RFStrategy/CFGFileManager.hpp"
+#include "TestCommon.hpp"
+
+static CFGFileParser::CFGFileParserPtr Get(const char *name) {
+  return CFGFileManager::GetInstance().GetParser("FE", name);
+}
+
+int main() {
+  Test::TempDir dir("parser_cache");
+  std::filesystem::create_directories(dir.File("Configs/FE"));
+  for (const char *name : {"A.csv", "B.csv", "C.csv", "D.csv", "E.csv"})
+    dir.Write(std::string("Configs/FE/") + name, "Freq,Power\n100,1\n200,2\n300,3\n");
+
+  auto &manager = CFGFileManager::GetInstance();
+  manager.SetRootPath(dir.File(""));
+  manager.SetMemoryBudget(0);
+
+  // 同样内容的三个文件正好占满预算，第四个文件加载后须淘汰一个
+  auto a = Get("A.csv"), b = Get("B.csv"), c = Get("C.csv");
+  auto stats = manager.GetCacheStats();
+  EXPECT(stats.misses == 3 && stats.hits == 0 && stats.residentParsers == 3);
+  manager.SetMemoryBudget(stats.residentBytes);
+
+  // 命中A后加载D：B最久未使用，被淘汰，A保留
+  EXPECT(Get("A.csv") == a);
+  auto d = Get("D.csv");
+  stats = manager.GetCacheStats();
+  EXPECT(stats.misses == 4 && stats.hits == 1 && stats.evictions == 1 && stats.residentParsers == 3);
+  EXPECT(Get("A.csv") == a);
+  EXPECT(Get("C.csv") == c);
+  EXPECT(manager.GetCacheStats().evictions == 1);
+
+  // 此时使用顺序为D、A、C；依次命中C、A、D后D最新，重新加载B应淘汰C
+  EXPECT(Get("C.csv") == c && Get("A.csv") == a && Get("D.csv") == d);
+  auto b2 = Get("B.csv");
+  EXPECT(b2 != b); // 先前被淘汰，重新解析得到新的解析器
+  EXPECT(Get("A.csv") == a && Get("D.csv") == d);
+  stats = manager.GetCacheStats();
+  EXPECT(stats.misses == 5 && stats.evictions == 2 && stats.residentParsers == 3);
+
+  // 固定A后即使A最久未使用也不淘汰，加载E时淘汰未固定中最久未使用的B
+  manager.PinParser("FE", "A.csv");
+  EXPECT(Get("B.csv") == b2 && Get("D.csv") == d);
+  auto e = Get("E.csv");
+  EXPECT(Get("A.csv") == a && Get("D.csv") == d && Get("E.csv") == e);
+  stats = manager.GetCacheStats();
+  EXPECT(stats.misses == 6 && stats.evictions == 3 && stats.residentParsers == 3);
+  EXPECT(stats.residentBytes <= stats.budgetBytes);
+
+  // 解除固定后收紧预算，A成为最久未使用者之一被淘汰
+  manager.UnpinParser("FE", "A.csv");
+  manager.SetMemoryBudget(stats.residentBytes / 3);
+  stats = manager.GetCacheStats();
+  EXPECT(stats.residentParsers == 1 && stats.evictions == 5);
+  EXPECT(Get("E.csv") == e);
+
+  manager.SetMemoryBudget(0);
+  manager.Clear();
+  return Test::Failures();
+}
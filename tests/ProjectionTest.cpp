@@ -0,0 +1,119 @@
+// 列投影：各解析模式只保存投影列（按源文件中的列序），类型化与列名按投影后的表解析；
+// 跳过的列仍参与列数校验，未知列名报错；投影解析不写.csvbin快照，不能追加写回，整表写出只含投影列
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "CSVReader.h"
+#include "TestCommon.hpp"
+
+using Cells = std::vector<std::vector<std::string>>;
+
+static Cells Collect(const CSVTable &table) {
+  Cells cells;
+  for (auto row : table)
+    cells.emplace_back(row.begin(), row.end());
+  return cells;
+}
+
+static void Configure(CSVParser &parser) {
+  parser.SetProjection({"Power", "Freq"});
+  parser.SetColumnSchema({{"Freq", ColumnType::Double}, {"Power", ColumnType::Double}});
+}
+
+template <typename Exception, typename Fn> static bool Throws(Fn &&fn) {
+  try {
+    fn();
+  } catch (const Exception &) {
+    return true;
+  }
+  return false;
+}
+
+int main() {
+  Test::TempDir dir("projection");
+  std::string content = "PortNo,Name,Freq,Power,Note\n";
+  Cells expected;
+  for (size_t row = 0; row < 5000; ++row) {
+    const auto freq = std::to_string(100 + row), power = std::to_string(-static_cast<int>(row % 40));
+    content += std::to_string(row) + ",port" + std::to_string(row) + "," + freq + "," + power + ",n\n";
+    expected.push_back({freq, power});
+  }
+  const auto path = dir.Write("table.csv", content);
+
+  // 各模式结果一致：列序按源文件，而不是SetProjection中给出的顺序
+  for (auto mode : {ParseMode::Synchronous, ParseMode::Asynchronous, ParseMode::MemoryMapped, ParseMode::Lazy}) {
+    CSVParser parser(mode);
+    Configure(parser);
+    parser.ParseDataFromCSV(path);
+    EXPECT(parser.GetTableColumnNames() == std::vector<std::string_view>({"Freq", "Power"}));
+    const auto &table = parser.GetCSVData();
+    EXPECT(table.CellCount() == table.size() * 2);
+    EXPECT(Collect(table) == expected);
+    EXPECT(table.TypeOf(0) == ColumnType::Double && table.TypeOf(1) == ColumnType::Double);
+    EXPECT(table.DoubleColumn(0).size() == 5000 && table.DoubleColumn(0)[7] == 107);
+    EXPECT(table.NumericAt<double>(41, 1) == -1);
+  }
+
+  // 按换行对齐的区间并行切分同样只保存投影列
+  {
+    AsynchronousParser parser(std::make_shared<ThreadPool>(4), 0);
+    parser.SetProjection({"Power", "Freq"});
+    FileManager file(path);
+    auto handler = file.CreateFileHandler();
+    parser.ParseDataFromCSV(handler, file.GetFileSize());
+    EXPECT(Collect(parser.GetCSVData()) == expected);
+  }
+
+  // 跳过的列缺失同样报错，报告的是文件中的行号
+  {
+    const auto bad = dir.Write("bad.csv", "PortNo,Name,Freq,Power,Note\n0,a,100,-1,n\n1,b,101,-2\n");
+    CSVParser parser(ParseMode::Synchronous);
+    Configure(parser);
+    bool reported = false;
+    try {
+      parser.ParseDataFromCSV(bad);
+    } catch (const ExceptionManager::InvalidDataLine &ex) {
+      reported = std::string(ex.what()).find("line: 3") != std::string::npos;
+    }
+    EXPECT(reported);
+  }
+  {
+    CSVParser parser(ParseMode::Synchronous);
+    parser.SetProjection({"Freq", "Gain"});
+    EXPECT(Throws<ExceptionManager::InvalidHeaderLine>([&] { parser.ParseDataFromCSV(path); }));
+  }
+
+  // 快照保存完整表：投影解析既不写也不读快照
+  {
+    const auto cache = dir.File("cache");
+    std::filesystem::create_directories(cache);
+    for (int pass = 0; pass < 2; ++pass) {
+      CSVParser parser(ParseMode::Synchronous);
+      Configure(parser);
+      parser.EnableBinaryCache(cache);
+      parser.ParseDataFromCSV(path);
+      EXPECT(parser.GetParseProfile().source == ParseProfile::Source::File);
+    }
+    EXPECT(std::filesystem::is_empty(cache));
+  }
+
+  // 写回：追加会丢失未投影的列，直接拒绝；整表写出只含投影列
+  {
+    CSVParser parser(ParseMode::Synchronous);
+    Configure(parser);
+    parser.ParseDataFromCSV(path);
+    EXPECT(Throws<ExceptionManager::CSVException>([&] { parser.AppendCSVDataToFile(path); }));
+    const auto out = dir.File("projected.csv");
+    parser.WriteCSVDataToFile(out);
+    std::ifstream in(out, std::ios::binary);
+    const std::string written((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    EXPECT(written.rfind("Freq,Power\n100,0\n101,-1\n", 0) == 0);
+    std::ifstream source(path, std::ios::binary);
+    EXPECT(std::string((std::istreambuf_iterator<char>(source)), std::istreambuf_iterator<char>()) == content);
+  }
+  return Test::Failures();
+}
@@ -0,0 +1,109 @@
+// 按换行对齐的区间并行解析：多个区间的结果与同步解析逐格一致（含\r\n行尾、末行无换行）；
+// 解析器不识别引号，引号内的换行在各模式下都是行分隔符，落在区间边界上时报错的行号与同步解析相同
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "CSVReader.h"
+#include "TestCommon.hpp"
+
+constexpr size_t kThreads = 4;
+// 定长行，kRows行的数据区约272KiB，足以按kMinRangeBytes(64KiB)切成kThreads个区间
+constexpr size_t kRows = 2400 * kThreads;
+constexpr size_t kRowBytes = 29;
+
+static std::string FixedRow(size_t row) {
+  char buffer[kRowBytes + 1];
+  std::snprintf(buffer, sizeof(buffer), "%08zu,%08zu,name%06zu\n", row, row * 3, row % 1000);
+  return buffer;
+}
+
+static void Parse(ParserStrategy &parser, const std::string &path) {
+  FileManager file(path);
+  auto handler = file.CreateFileHandler();
+  parser.ParseDataFromCSV(handler, file.GetFileSize());
+}
+
+static std::vector<std::vector<std::string>> Cells(const CSVTable &table) {
+  std::vector<std::vector<std::string>> cells;
+  for (auto row : table)
+    cells.emplace_back(row.begin(), row.end());
+  return cells;
+}
+
+// 两种解析的结果（或异常信息）
+static std::string Outcome(ParserStrategy &parser, const std::string &path,
+                           std::vector<std::vector<std::string>> &out) {
+  try {
+    Parse(parser, path);
+  } catch (const ExceptionManager::CSVException &ex) {
+    return ex.what();
+  }
+  out = Cells(parser.GetCSVData());
+  return {};
+}
+
+static void ExpectSameAsSync(const std::string &path, bool named) {
+  auto pool = std::make_shared<ThreadPool>(kThreads);
+  SynchronousParser sync;
+  AsynchronousParser async(pool, 0);
+  if (named) {
+    sync.SetColumnNames({"A", "B", "C"});
+    async.SetColumnNames({"A", "B", "C"});
+  }
+  std::vector<std::vector<std::string>> expected, actual;
+  const auto syncError = Outcome(sync, path, expected);
+  const auto asyncError = Outcome(async, path, actual);
+  EXPECT(asyncError == syncError);
+  EXPECT(actual == expected);
+}
+
+int main() {
+  Test::TempDir dir("range_parse");
+
+  // 变长行：边界落在行中间，推进到下一个换行之后
+  std::string varied = "A,B,C\n";
+  for (size_t row = 0; varied.size() < kRows * kRowBytes; ++row)
+    varied += std::to_string(row) + "," + std::string(row % 17 + 1, 'x') + "," + std::to_string(row * 7) + "\n";
+  ExpectSameAsSync(dir.Write("varied.csv", varied), false);
+  ExpectSameAsSync(dir.Write("varied_no_eol.csv", varied + "last,row,0"), true);
+
+  // \r\n行尾
+  std::string crlf = "A,B,C\r\n";
+  for (size_t row = 0; row < kRows; ++row) {
+    auto line = FixedRow(row);
+    crlf += line.substr(0, line.size() - 1) + "\r\n";
+  }
+  ExpectSameAsSync(dir.Write("crlf.csv", crlf), true);
+
+  // 定长行：每个边界恰好落在一行的开头
+  std::string fixed = "A,B,C\n";
+  for (size_t row = 0; row < kRows; ++row)
+    fixed += FixedRow(row);
+  ExpectSameAsSync(dir.Write("fixed.csv", fixed), true);
+  {
+    AsynchronousParser async(std::make_shared<ThreadPool>(kThreads), 0);
+    Parse(async, dir.File("fixed.csv"));
+    const auto &table = async.GetCSVData();
+    EXPECT(table.size() == kRows);
+    for (size_t row = 0; row < kRows; row += kRows / kThreads - 1)
+      EXPECT(table[row][0] == FixedRow(row).substr(0, 8));
+  }
+
+  // 引号内的换行恰好落在第1个和第3个边界上：该行被拆成两行，同步与并行都在同一行号报列数错误
+  const std::string quoted = "\"q\nqqqq\",00000000,name000000\n";
+  EXPECT(quoted.size() == kRowBytes);
+  for (size_t boundary : {size_t{1}, size_t{3}}) {
+    std::string content = fixed;
+    const size_t row = kRows * boundary / kThreads;
+    content.replace(6 + row * kRowBytes, kRowBytes, quoted);
+    ExpectSameAsSync(dir.Write("quoted.csv", content), true);
+    AsynchronousParser async(std::make_shared<ThreadPool>(kThreads), 0);
+    async.SetColumnNames({"A", "B", "C"});
+    std::vector<std::vector<std::string>> unused;
+    EXPECT(Outcome(async, dir.File("quoted.csv"), unused) ==
+           ExceptionManager::InvalidDataLine(row + 2, "Invalid columns").what());
+  }
+  return Test::Failures();
+}
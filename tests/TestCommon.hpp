@@ -0,0 +1,52 @@
+#ifndef TEST_COMMON_HPP
+#define TEST_COMMON_HPP
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include <unistd.h>
+
+// 各测试程序共用的断言与临时文件工具；main返回Test::Failures()，非0即失败
+namespace Test {
+
+inline int &Failures() {
+  static int failures = 0;
+  return failures;
+}
+
+// 进程私有的临时目录，析构时删除
+class TempDir {
+public:
+  explicit TempDir(const std::string &name)
+      : m_path(std::filesystem::temp_directory_path() / (name + "_" + std::to_string(::getpid()))) {
+    std::filesystem::remove_all(m_path);
+    std::filesystem::create_directories(m_path);
+  }
+  ~TempDir() {
+    std::error_code ec;
+    std::filesystem::remove_all(m_path, ec);
+  }
+  std::string File(const std::string &name) const { return (m_path / name).string(); }
+  std::string Write(const std::string &name, const std::string &content) const {
+    const auto path = File(name);
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << content;
+    return path;
+  }
+
+private:
+  std::filesystem::path m_path;
+};
+
+} // namespace Test
+
+#define EXPECT(cond)                                                                                                   \
+  do {                                                                                                                 \
+    if (!(cond)) {                                                                                                     \
+      std::fprintf(stderr, "%s:%d: EXPECT(%s) failed\n", __FILE__, __LINE__, #cond);                                   \
+      ++Test::Failures();                                                                                              \
+    }                                                                                                                  \
+  } while (0)
+
+#endif // TEST_COMMON_HPP
@@ -0,0 +1,123 @@
+// ThreadPool::ParallelFor的领取与等待：每个下标恰好执行一次，返回前其他线程手上的下标都已完成；
+// 池内线程全部被占用时调用线程独自做完，池内嵌套调用不死锁，迟到出队的辅助任务不再访问fn；
+// 首个异常在全部下标完成后重新抛出
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "TestCommon.hpp"
+#include "ThreadPool.hpp"
+
+// 占住一个池内线程，直到Release
+class Blocker {
+public:
+  void Hold(ThreadPool &pool) {
+    pool.Submit([this] {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_started = true;
+      m_changed.notify_all();
+      m_changed.wait(lock, [this] { return m_released; });
+    });
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_changed.wait(lock, [this] { return m_started; });
+  }
+  void Release() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_released = true;
+    m_changed.notify_all();
+  }
+
+private:
+  std::mutex m_mutex;
+  std::condition_variable m_changed;
+  bool m_started = false;
+  bool m_released = false;
+};
+
+int main() {
+  // 每个下标恰好一次
+  {
+    ThreadPool pool(4);
+    std::vector<std::atomic<int>> hits(10000);
+    pool.ParallelFor(hits.size(), [&hits](size_t i) { hits[i].fetch_add(1, std::memory_order_relaxed); });
+    size_t once = 0;
+    for (const auto &hit : hits)
+      once += hit.load() == 1;
+    EXPECT(once == hits.size());
+    pool.ParallelFor(0, [](size_t) { EXPECT(!"ParallelFor(0) must not call fn"); });
+  }
+
+  // 辅助线程领到的慢下标：调用线程做完其余下标后等待它完成，而不是提前返回
+  {
+    ThreadPool pool(2);
+    std::atomic<size_t> finished{0};
+    std::atomic<bool> helperClaimed{false};
+    const auto caller = std::this_thread::get_id();
+    pool.ParallelFor(8, [&](size_t) {
+      if (std::this_thread::get_id() != caller) {
+        helperClaimed = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      } else {
+        // 调用线程先等辅助线程领到一个下标，保证确有下标在其他线程上执行
+        for (int i = 0; i < 200 && !helperClaimed; ++i)
+          std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      }
+      finished.fetch_add(1);
+    });
+    EXPECT(helperClaimed.load());
+    EXPECT(finished.load() == 8);
+  }
+
+  // 唯一的池内线程被占住：调用线程独自领完全部下标；辅助任务在返回后才出队，此时不再调用fn
+  {
+    ThreadPool pool(1);
+    Blocker blocker;
+    blocker.Hold(pool);
+    std::atomic<size_t> calls{0};
+    {
+      std::vector<int> local(100, 0); // fn引用的数据在ParallelFor返回后即销毁
+      pool.ParallelFor(local.size(), [&](size_t i) {
+        ++local[i];
+        calls.fetch_add(1);
+      });
+      EXPECT(calls.load() == 100);
+    }
+    blocker.Release();
+    while (pool.TryRunPendingTask()) {
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT(calls.load() == 100);
+  }
+
+  // 池内线程中嵌套调用：外层占满全部池内线程，内层由各自的调用线程做完
+  {
+    ThreadPool pool(2);
+    std::atomic<size_t> inner{0};
+    pool.ParallelFor(4, [&](size_t) { pool.ParallelFor(50, [&](size_t) { inner.fetch_add(1); }); });
+    EXPECT(inner.load() == 200);
+  }
+
+  // 异常：其余下标照常执行完，之后重新抛出首个异常
+  {
+    ThreadPool pool(3);
+    std::atomic<size_t> calls{0};
+    bool thrown = false;
+    try {
+      pool.ParallelFor(64, [&](size_t i) {
+        calls.fetch_add(1);
+        if (i % 16 == 5)
+          throw std::runtime_error("index failed");
+      });
+    } catch (const std::runtime_error &ex) {
+      thrown = std::string(ex.what()) == "index failed";
+    }
+    EXPECT(thrown);
+    EXPECT(calls.load() == 64);
+  }
+  return Test::Failures();
+}
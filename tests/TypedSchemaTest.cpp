@@ -0,0 +1,72 @@
+// TypedCSVParser：显式列布局必须覆盖schema全部列、可用kSkip跳过文件列；解析失败后表被清空
+#include <string>
+#include <string_view>
+
+#include "CSVSchema.hpp"
+#include "TestCommon.hpp"
+
+using Schema = CSVSchema<Column<"Freq", double>, Column<"Power", double>, Column<"Tag", std::string_view>>;
+using Parser = TypedCSVParser<Schema>;
+
+// 缺列或重复的布局在编译期被拒绝
+static_assert(Parser::IsCompleteLayout<"Freq", "Power", "Tag">());
+static_assert(Parser::IsCompleteLayout<"Tag", Parser::kSkip, "Freq", Parser::kSkip, "Power">());
+static_assert(!Parser::IsCompleteLayout<"Freq", "Power">());
+static_assert(!Parser::IsCompleteLayout<"Freq", Parser::kSkip, "Tag">());
+static_assert(!Parser::IsCompleteLayout<"Freq", "Power", "Tag", "Freq">());
+
+int main() {
+  Test::TempDir dir("typed_schema");
+
+  // 按布局跳过文件中的Extra列
+  {
+    Parser parser;
+    parser.SetColumnNames<"Freq", Parser::kSkip, "Power", "Tag">();
+    parser.ParseDataFromCSV(dir.Write("skip.csv", "f,extra,p,t\n100.5,x,-3,a\n200,y,-4,b\n"));
+    const auto &table = parser.GetCSVData();
+    EXPECT(table.size() == 2);
+    EXPECT(table.col<"Freq">().size() == 2 && table.col<"Power">().size() == 2 && table.col<"Tag">().size() == 2);
+    EXPECT(table.at<"Freq">(1) == 200.0);
+    EXPECT(table.at<"Power">(0) == -3.0);
+    EXPECT(table.at<"Tag">(1) == "b");
+  }
+
+  // 解析失败后不保留半张表，也不保留上一次的结果
+  {
+    Parser parser;
+    parser.ParseDataFromCSV(dir.Write("good.csv", "Freq,Power,Tag\n1,2,a\n3,4,b\n"));
+    EXPECT(parser.GetCSVDataSize() == 2);
+    bool thrown = false;
+    try {
+      parser.ParseDataFromCSV(dir.Write("bad.csv", "Freq,Power,Tag\n1,2,a\n3,oops,b\n5,6,c\n"));
+    } catch (const ExceptionManager::InvalidDataLine &) {
+      thrown = true;
+    }
+    EXPECT(thrown);
+    EXPECT(parser.GetCSVDataSize() == 0);
+    EXPECT(parser.GetCSVData().col<"Freq">().empty() && parser.GetCSVData().col<"Tag">().empty());
+
+    thrown = false;
+    try {
+      parser.ParseDataFromCSV(dir.Write("short.csv", "Freq,Power,Tag\n1,2,a\n3,4\n"));
+    } catch (const ExceptionManager::InvalidDataLine &) {
+      thrown = true;
+    }
+    EXPECT(thrown);
+    EXPECT(parser.GetCSVDataSize() == 0 && parser.GetCSVData().col<"Freq">().empty());
+  }
+
+  // 表头中重复的列会让该列元素翻倍，按表头解析时拒绝
+  {
+    Parser parser;
+    bool thrown = false;
+    try {
+      parser.ParseDataFromCSV(dir.Write("dup.csv", "Freq,Power,Tag,Freq\n1,2,a,3\n"));
+    } catch (const ExceptionManager::InvalidHeaderLine &) {
+      thrown = true;
+    }
+    EXPECT(thrown);
+    EXPECT(parser.GetCSVDataSize() == 0);
+  }
+  return Test::Failures();
+}
@@ -0,0 +1,74 @@
+// VersionedTable追加行：基础表在版本间共享而不复制，追加跨越多个尾段后行序、数值列与旧快照都保持正确；
+// 追加失败时当前版本不变
+#include <string>
+#include <vector>
+
+#include "CSVReader.h"
+#include "CSVVersionedTable.hpp"
+#include "TestCommon.hpp"
+
+static std::vector<std::string> Row(size_t row) { return {std::to_string(row), std::to_string(row * 2)}; }
+
+int main() {
+  constexpr size_t kBaseRows = 5000;
+  Test::TempDir dir("versioned_table");
+  std::string content = "Freq,Power\n";
+  for (size_t row = 0; row < kBaseRows; ++row)
+    content += Row(row)[0] + "," + Row(row)[1] + "\n";
+  const auto path = dir.Write("base.csv", content);
+
+  CSVParser parser(ParseMode::MemoryMapped);
+  parser.SetColumnSchema({{"Freq", ColumnType::Double}, {"Power", ColumnType::Double}});
+  parser.ParseDataFromCSV(path);
+  auto source = parser.GetSourceBuffer();
+  VersionedTable versions;
+  versions.Reset(parser.TakeCSVData(), std::move(source));
+
+  auto first = versions.AcquireVersioned();
+  EXPECT(first.table->size() == kBaseRows);
+  EXPECT(first.table->DoubleColumn(0).size() == kBaseRows);
+  const auto *baseSegment = first.table->Segments().front().get();
+
+  // 逐行追加，跨过若干个尾段上限
+  const size_t appended = VersionedTable::kTailChunkRows * 2 + 7;
+  for (size_t i = 0; i < appended; ++i)
+    versions.AppendRows({Row(kBaseRows + i)});
+
+  auto last = versions.AcquireVersioned();
+  const auto &table = *last.table;
+  EXPECT(last.base == first.base);
+  EXPECT(last.number == first.number + appended);
+  EXPECT(table.size() == kBaseRows + appended);
+  EXPECT(table.Segments().front().get() == baseSegment);
+  EXPECT(table.Segments().size() == 4);
+  for (size_t row = 0; row < table.size(); ++row) {
+    auto expected = Row(row);
+    auto view = table[row];
+    if (view.size() != 2 || view[0] != expected[0] || view[1] != expected[1] ||
+        table.NumericAt<double>(row, 1) != static_cast<double>(row * 2)) {
+      EXPECT(!"row mismatch");
+      break;
+    }
+  }
+  size_t segmentRows = 0;
+  table.ForEachSegment([&](const CSVTable &segment, size_t firstRow) {
+    EXPECT(firstRow == segmentRows);
+    EXPECT(segment.DoubleColumn(0).size() == segment.size());
+    segmentRows += segment.size();
+  });
+  EXPECT(segmentRows == table.size());
+  EXPECT(first.table->size() == kBaseRows);
+
+  // 类型转换失败：抛异常，当前版本不变
+  bool threw = false;
+  try {
+    versions.AppendRows({Row(1), {"bad", "1"}});
+  } catch (const ExceptionManager::CSVException &) {
+    threw = true;
+  }
+  EXPECT(threw);
+  EXPECT(versions.VersionNumber() == last.number);
+  EXPECT(versions.Acquire()->size() == kBaseRows + appended);
+
+  return Test::Failures();
+}